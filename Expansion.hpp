@@ -0,0 +1,357 @@
+// Expansion.hpp
+//
+// Expansion<N>: exact floating-point expansion of at most N doubles.
+//
+// An expansion represents the exact sum of its terms, which are nonoverlapping
+// and sorted by increasing magnitude (Shewchuk, "Adaptive Precision
+// Floating-Point Arithmetic and Fast Robust Geometric Predicates").  Sums and
+// products of doubles are built with error-free transformations (two_sum,
+// two_product), so moderate-precision exact arithmetic needs neither
+// allocation nor big-number limbs: everything stays in a stack array whose
+// capacity is a compile-time bound of the result, e.g.
+//     sum(Expansion<M>, Expansion<N>)     -> Expansion<M + N>
+//     scale(Expansion<N>, double)         -> Expansion<2 * N>
+//     product(Expansion<M>, Expansion<N>) -> Expansion<2 * M * N>
+// The operations drop zero terms, so the actual size is usually far below the
+// capacity; compress() shortens an expansion further without changing its
+// value.
+//
+// Exactness requires IEEE double arithmetic with round-to-nearest and no
+// overflow or underflow.  to_MiniMPF() converts the exact value for further
+// MiniMPF arithmetic.
+
+#ifndef EXPANSION_HPP
+#define EXPANSION_HPP
+
+#include "MiniMPF.hpp"
+#include <cmath>
+
+namespace expansion_detail {
+
+// x + y == a + b exactly, x = fl(a + b)
+inline void two_sum(double a, double b, double& x, double& y) {
+    x = a + b;
+    const double bvirt = x - a;
+    const double avirt = x - bvirt;
+    y = (a - avirt) + (b - bvirt);
+}
+
+// Same as two_sum, for |a| >= |b| (or a == 0)
+inline void fast_two_sum(double a, double b, double& x, double& y) {
+    x = a + b;
+    y = b - (x - a);
+}
+
+// x + y == a - b exactly, x = fl(a - b)
+inline void two_diff(double a, double b, double& x, double& y) {
+    x = a - b;
+    const double bvirt = a - x;
+    const double avirt = x + bvirt;
+    y = (a - avirt) + (bvirt - b);
+}
+
+// x + y == a * b exactly, x = fl(a * b)
+inline void two_product(double a, double b, double& x, double& y) {
+    x = a * b;
+#ifdef FP_FAST_FMA
+    y = std::fma(a, b, -x);
+#else
+    // Dekker's product: split each factor into two 26-bit halves.
+    const double splitter = 134217729.0;  // 2^27 + 1
+    double c = splitter * a;
+    const double ahi = c - (c - a);
+    const double alo = a - ahi;
+    c = splitter * b;
+    const double bhi = c - (c - b);
+    const double blo = b - bhi;
+    const double err1 = x - ahi * bhi;
+    const double err2 = err1 - alo * bhi;
+    const double err3 = err2 - ahi * blo;
+    y = alo * blo - err3;
+#endif
+}
+
+// The kernels below are Shewchuk's *_zeroelim routines. Inputs have at least
+// one term; outputs are written to h and their length is returned (at least 1,
+// a single 0.0 for zero).
+
+inline int grow(const double* e, int elen, double b, double* h) {
+    int hindex = 0;
+    double q = b;
+    for (int i = 0; i < elen; ++i) {
+        double qnew, hh;
+        two_sum(q, e[i], qnew, hh);
+        q = qnew;
+        if (hh != 0.0) {
+            h[hindex++] = hh;
+        }
+    }
+    if (q != 0.0 || hindex == 0) {
+        h[hindex++] = q;
+    }
+    return hindex;
+}
+
+// Shewchuk's fast_expansion_sum: merge the terms of e and f by increasing
+// magnitude and accumulate them with two_sum.
+inline int sum(const double* e, int elen, const double* f, int flen, double* h) {
+    int eindex = 0, findex = 0, hindex = 0;
+    double q = 0.0;
+    bool first = true;
+    while (eindex < elen || findex < flen) {
+        double next;
+        if (findex == flen) {
+            next = e[eindex++];
+        } else if (eindex == elen) {
+            next = f[findex++];
+        } else if ((f[findex] > e[eindex]) == (f[findex] > -e[eindex])) {
+            next = e[eindex++];
+        } else {
+            next = f[findex++];
+        }
+        if (first) {
+            q = next;
+            first = false;
+            continue;
+        }
+        double qnew, hh;
+        two_sum(q, next, qnew, hh);
+        q = qnew;
+        if (hh != 0.0) {
+            h[hindex++] = hh;
+        }
+    }
+    if (q != 0.0 || hindex == 0) {
+        h[hindex++] = q;
+    }
+    return hindex;
+}
+
+inline int scale(const double* e, int elen, double b, double* h) {
+    int hindex = 0;
+    double q, hh;
+    two_product(e[0], b, q, hh);
+    if (hh != 0.0) {
+        h[hindex++] = hh;
+    }
+    for (int i = 1; i < elen; ++i) {
+        double product1, product0, s;
+        two_product(e[i], b, product1, product0);
+        two_sum(q, product0, s, hh);
+        if (hh != 0.0) {
+            h[hindex++] = hh;
+        }
+        fast_two_sum(product1, s, q, hh);
+        if (hh != 0.0) {
+            h[hindex++] = hh;
+        }
+    }
+    if (q != 0.0 || hindex == 0) {
+        h[hindex++] = q;
+    }
+    return hindex;
+}
+
+// In place; returns the new length.
+inline int compress(double* e, int elen) {
+    int bottom = elen - 1;
+    double q = e[bottom];
+    for (int i = elen - 2; i >= 0; --i) {
+        double qnew, small;
+        fast_two_sum(q, e[i], qnew, small);
+        if (small != 0.0) {
+            e[bottom--] = qnew;
+            q = small;
+        } else {
+            q = qnew;
+        }
+    }
+    int top = 0;
+    for (int i = bottom + 1; i < elen; ++i) {
+        double qnew, small;
+        fast_two_sum(e[i], q, qnew, small);
+        if (small != 0.0) {
+            e[top++] = small;
+        }
+        q = qnew;
+    }
+    e[top++] = q;
+    return top;
+}
+
+} // namespace expansion_detail
+
+template<int N>
+class Expansion {
+    static_assert(N > 0, "Expansion capacity must be positive");
+
+private:
+    double m_Terms[N];
+    int m_Size;
+
+    template<int M> friend class Expansion;
+
+    template<int A, int B>
+    friend Expansion<A + B> sum(const Expansion<A>& e, const Expansion<B>& f);
+    template<int A>
+    friend Expansion<A + 1> grow(const Expansion<A>& e, double b);
+    template<int A>
+    friend Expansion<2 * A> scale(const Expansion<A>& e, double b);
+    template<int A, int B>
+    friend Expansion<2 * A * B> product(const Expansion<A>& e, const Expansion<B>& f);
+    template<int A>
+    friend Expansion<A> operator-(const Expansion<A>& e);
+
+public:
+    // Zero
+    Expansion() : m_Size(1) { m_Terms[0] = 0.0; }
+
+    explicit
+    Expansion(double x) : m_Size(1) { m_Terms[0] = x; }
+
+    // Widening copy from a smaller expansion
+    template<int M>
+    Expansion(const Expansion<M>& other) : m_Size(other.m_Size) {
+        static_assert(M <= N, "Expansion: narrowing conversion");
+        for (int i = 0; i < m_Size; ++i) {
+            m_Terms[i] = other.m_Terms[i];
+        }
+    }
+
+    // Exact a + b, a - b and a * b of two doubles
+    static Expansion from_sum(double a, double b) {
+        static_assert(N >= 2, "from_sum needs capacity 2");
+        Expansion r;
+        expansion_detail::two_sum(a, b, r.m_Terms[1], r.m_Terms[0]);
+        r.m_Size = 2;
+        r.drop_low_zero();
+        return r;
+    }
+
+    static Expansion from_diff(double a, double b) {
+        static_assert(N >= 2, "from_diff needs capacity 2");
+        Expansion r;
+        expansion_detail::two_diff(a, b, r.m_Terms[1], r.m_Terms[0]);
+        r.m_Size = 2;
+        r.drop_low_zero();
+        return r;
+    }
+
+    static Expansion from_product(double a, double b) {
+        static_assert(N >= 2, "from_product needs capacity 2");
+        Expansion r;
+        expansion_detail::two_product(a, b, r.m_Terms[1], r.m_Terms[0]);
+        r.m_Size = 2;
+        r.drop_low_zero();
+        return r;
+    }
+
+    // Terms, by increasing magnitude
+    int size() const { return m_Size; }
+    static constexpr int capacity() { return N; }
+    double operator[](int i) const { return m_Terms[i]; }
+    const double* data() const { return m_Terms; }
+
+    // Sign of the exact value: that of the largest term.
+    int sign() const {
+        const double top = m_Terms[m_Size - 1];
+        return (top > 0.0) - (top < 0.0);
+    }
+
+    // Double approximation of the value.
+    double estimate() const {
+        double s = m_Terms[0];
+        for (int i = 1; i < m_Size; ++i) {
+            s += m_Terms[i];
+        }
+        return s;
+    }
+
+    bool is_finite() const {
+        for (int i = 0; i < m_Size; ++i) {
+            if (!std::isfinite(m_Terms[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Shorten the representation without changing the value.
+    void compress() { m_Size = expansion_detail::compress(m_Terms, m_Size); }
+
+    // Exact even under a MiniMPF precision limit.
+    MiniMPF to_MiniMPF() const {
+        const MiniMPFPrecisionScope exact_arithmetic(0);
+        MiniMPF result;
+        for (int i = 0; i < m_Size; ++i) {
+            if (m_Terms[i] != 0.0) {
+                result += MiniMPF(m_Terms[i]);
+            }
+        }
+        return result;
+    }
+
+private:
+    void drop_low_zero() {
+        if (m_Terms[0] == 0.0) {
+            m_Terms[0] = m_Terms[1];
+            m_Size = 1;
+        }
+    }
+};
+
+template<int A, int B>
+Expansion<A + B> sum(const Expansion<A>& e, const Expansion<B>& f) {
+    Expansion<A + B> r;
+    r.m_Size = expansion_detail::sum(e.m_Terms, e.m_Size, f.m_Terms, f.m_Size, r.m_Terms);
+    return r;
+}
+
+template<int A>
+Expansion<A> operator-(const Expansion<A>& e) {
+    Expansion<A> r;
+    r.m_Size = e.m_Size;
+    for (int i = 0; i < e.m_Size; ++i) {
+        r.m_Terms[i] = -e.m_Terms[i];
+    }
+    return r;
+}
+
+template<int A, int B>
+Expansion<A + B> difference(const Expansion<A>& e, const Expansion<B>& f) {
+    return sum(e, -f);
+}
+
+template<int A>
+Expansion<A + 1> grow(const Expansion<A>& e, double b) {
+    Expansion<A + 1> r;
+    r.m_Size = expansion_detail::grow(e.m_Terms, e.m_Size, b, r.m_Terms);
+    return r;
+}
+
+template<int A>
+Expansion<2 * A> scale(const Expansion<A>& e, double b) {
+    Expansion<2 * A> r;
+    r.m_Size = expansion_detail::scale(e.m_Terms, e.m_Size, b, r.m_Terms);
+    return r;
+}
+
+// e * f as the sum of e scaled by each term of f.
+template<int A, int B>
+Expansion<2 * A * B> product(const Expansion<A>& e, const Expansion<B>& f) {
+    Expansion<2 * A * B> r;
+    r.m_Size = expansion_detail::scale(e.m_Terms, e.m_Size, f.m_Terms[0], r.m_Terms);
+    double partial[2 * A];
+    double merged[2 * A * B];
+    for (int i = 1; i < f.m_Size; ++i) {
+        const int plen = expansion_detail::scale(e.m_Terms, e.m_Size, f.m_Terms[i], partial);
+        const int mlen = expansion_detail::sum(r.m_Terms, r.m_Size, partial, plen, merged);
+        for (int k = 0; k < mlen; ++k) {
+            r.m_Terms[k] = merged[k];
+        }
+        r.m_Size = mlen;
+    }
+    return r;
+}
+
+#endif // EXPANSION_HPP
@@ -4,13 +4,29 @@
 
 #include "mini-gmp-plus-config.hpp"
 #include "MiniMPZ.hpp"
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <functional>
 #include <limits>
+#include <stdexcept>
 #include <string>
 #include <ostream>
 
+// Rounding modes for the operations that cannot be exact (div, sqrt,
+// round_to_precision), named after the <cfenv> modes.
+enum class MiniMPFRounding {
+    ToNearest,    // nearest, ties to even
+    TowardZero,
+    Upward,       // toward +infinity
+    Downward      // toward -infinity
+};
+
+// Precision limit for MiniMPF arithmetic (see MiniMPF::set_precision_limit).
+struct MiniMPFPrecision {
+    int bits;                    // 0: no limit, arithmetic is exact
+    MiniMPFRounding rounding;
+};
 
 class MiniMPF {
 private:
@@ -31,6 +47,181 @@ private:
          }
      }
 
+    // Round the positive integer m * 2^exp to `precision` bits. `sticky` tells
+    // that the true value is slightly above m * 2^exp (non-zero remainder
+    // below the last bit). `negative` is the sign of the final result, used
+    // for directed rounding.
+    static void round_magnitude(MiniMPZ& m, int& exp, int precision, MiniMPFRounding rounding,
+                                bool negative, bool sticky) {
+        mpz_t& z = m.get_mpz();
+        long drop = static_cast<long>(mpz_sizeinbase(z, 2)) - precision;
+        if (drop <= 0) {
+            if (!sticky) {
+                return;
+            }
+            // One extra bit so the discarded part sits below the last bit.
+            mpz_mul_2exp(z, z, static_cast<mp_bitcnt_t>(1 - drop));
+            exp -= static_cast<int>(1 - drop);
+            drop = 1;
+        }
+        const mp_bitcnt_t d = static_cast<mp_bitcnt_t>(drop);
+        const bool half = mpz_tstbit(z, d - 1) != 0;
+        const bool below_half = sticky || mpz_scan1(z, 0) < d - 1;
+        mpz_tdiv_q_2exp(z, z, d);
+        exp += static_cast<int>(drop);
+
+        bool increment = false;
+        switch (rounding) {
+            case MiniMPFRounding::ToNearest:
+                increment = half && (below_half || mpz_odd_p(z));
+                break;
+            case MiniMPFRounding::TowardZero:
+                break;
+            case MiniMPFRounding::Upward:
+                increment = !negative && (half || below_half);
+                break;
+            case MiniMPFRounding::Downward:
+                increment = negative && (half || below_half);
+                break;
+        }
+        if (increment) {
+            mpz_add_ui(z, z, 1);
+        }
+    }
+
+    static MiniMPFPrecision& precision_context() {
+        thread_local MiniMPFPrecision context = { 0, MiniMPFRounding::ToNearest };
+        return context;
+    }
+
+    // Round to the thread's precision limit, if any.
+    void apply_precision_limit() {
+        const MiniMPFPrecision& context = precision_context();
+        if (MINI_GMP_PLUS_EXPECT(context.bits == 0, 1)) {
+            return;
+        }
+        if (mpz_sizeinbase(m_Mantisse.get_mpz(), 2) > static_cast<size_t>(context.bits)) {
+            round_to_precision(context.bits, context.rounding);
+        }
+    }
+
+    // Add cy (resp. subtract borrow) into {p, n}, stopping as soon as it is
+    // absorbed; anything past n is dropped (two's complement accumulator).
+    static void propagate_carry(mp_ptr p, mp_size_t n, mp_limb_t cy) {
+        for (mp_size_t i = 0; cy != 0 && i < n; ++i) {
+            p[i] += cy;
+            cy = p[i] < cy;
+        }
+    }
+
+    static void propagate_borrow(mp_ptr p, mp_size_t n, mp_limb_t borrow) {
+        for (mp_size_t i = 0; borrow != 0 && i < n; ++i) {
+            const mp_limb_t x = p[i];
+            p[i] = x - borrow;
+            borrow = x < borrow;
+        }
+    }
+
+    // Fast path of dot_product for n <= 16 single-limb mantissas (all values
+    // built from doubles) whose product exponents are at most 123 apart:
+    // each 128-bit product, shifted by its offset from the smallest exponent,
+    // fits in 3 limbs of a 256-bit two's complement accumulator on the stack,
+    // with room for the carries of 16 terms and the sign. Returns false,
+    // leaving result untouched, when the operands do not qualify.
+    static bool dot_product_small(const MiniMPF* a, const MiniMPF* b, size_t n, MiniMPF& result) {
+#if MINI_GMP_PLUS_HAS_UINT128
+        long min_exp = 0, max_exp = 0;
+        bool any = false;
+        for (size_t i = 0; i < n; ++i) {
+            const int sa = a[i].m_Mantisse.get_mpz()->_mp_size;
+            const int sb = b[i].m_Mantisse.get_mpz()->_mp_size;
+            if (sa < -1 || sa > 1 || sb < -1 || sb > 1) {
+                return false;
+            }
+            if (sa == 0 || sb == 0) {
+                continue;
+            }
+            const long e = static_cast<long>(a[i].m_Exponant) + b[i].m_Exponant;
+            min_exp = any ? std::min(min_exp, e) : e;
+            max_exp = any ? std::max(max_exp, e) : e;
+            any = true;
+        }
+        if (!any) {
+            result = MiniMPF();
+            return true;
+        }
+        if (max_exp - min_exp > 123) {
+            return false;
+        }
+
+        uint64_t acc[4] = { 0, 0, 0, 0 };
+        for (size_t i = 0; i < n; ++i) {
+            const mpz_t& ma = a[i].m_Mantisse.get_mpz();
+            const mpz_t& mb = b[i].m_Mantisse.get_mpz();
+            if (ma->_mp_size == 0 || mb->_mp_size == 0) {
+                continue;
+            }
+            const MINI_GMP_PLUS_UINT128_T p =
+                static_cast<MINI_GMP_PLUS_UINT128_T>(ma->_mp_d[0]) * mb->_mp_d[0];
+            const long offset = static_cast<long>(a[i].m_Exponant) + b[i].m_Exponant - min_exp;
+            const unsigned shift = static_cast<unsigned>(offset % 64);
+            const uint64_t lo = static_cast<uint64_t>(p);
+            const uint64_t hi = static_cast<uint64_t>(p >> 64);
+            uint64_t t[4] = { 0, 0, 0, 0 };
+            uint64_t* tq = t + offset / 64;
+            tq[0] = lo << shift;
+            tq[1] = shift != 0 ? (hi << shift) | (lo >> (64 - shift)) : hi;
+            tq[2] = shift != 0 ? hi >> (64 - shift) : 0;
+            if ((ma->_mp_size < 0) != (mb->_mp_size < 0)) {
+                uint64_t borrow = 0;
+                for (int k = 0; k < 4; ++k) {
+                    const uint64_t x = acc[k];
+                    const uint64_t d = x - t[k];
+                    const uint64_t b1 = x < t[k];
+                    acc[k] = d - borrow;
+                    borrow = b1 | (d < borrow);
+                }
+            } else {
+                uint64_t carry = 0;
+                for (int k = 0; k < 4; ++k) {
+                    const uint64_t s1 = acc[k] + t[k];
+                    const uint64_t c1 = s1 < t[k];
+                    acc[k] = s1 + carry;
+                    carry = c1 | (acc[k] < carry);
+                }
+            }
+        }
+
+        const bool negative = (acc[3] >> 63) != 0;
+        if (negative) {
+            uint64_t carry = 1;
+            for (int k = 0; k < 4; ++k) {
+                acc[k] = ~acc[k] + carry;
+                carry = carry & (acc[k] == 0);
+            }
+        }
+        mpz_t& z = result.m_Mantisse.get_mpz();
+        const mp_ptr d = mpz_limbs_write(z, 4);
+        for (int k = 0; k < 4; ++k) {
+            d[k] = acc[k];
+        }
+        mpz_limbs_finish(z, negative ? -4 : 4);
+        result.m_Exponant = static_cast<int>(min_exp);
+        result.normalize();
+        result.apply_precision_limit();
+        return true;
+#else
+        (void)a; (void)b; (void)n; (void)result;
+        return false;
+#endif
+    }
+
+    static void check_precision(int precision_bits) {
+        if (precision_bits < 1) {
+            throw std::invalid_argument("MiniMPF: precision must be at least 1 bit");
+        }
+    }
+
 public:
     // Constructors
     MiniMPF() : m_Mantisse(0L), m_Exponant(0) {}
@@ -120,32 +311,33 @@ public:
     int Exponent() const { return m_Exponant; }
 
     // Comparison methods
+    // Compares the bit lengths of the values first (mantissa size plus
+    // exponent), then the limbs of the mantissas aligned on the fly.
     int compare(const MiniMPF& other) const {
-        if (IsZero() && other.IsZero()) return 0;
-        
-        int s1 = Sign();
-        int s2 = other.Sign();
-        
+        const int s1 = Sign();
+        const int s2 = other.Sign();
         if (s1 != s2) {
             return (s1 > s2) ? 1 : -1;
         }
-        
         if (s1 == 0) return 0;
 
-        MiniMPZ lhs = m_Mantisse;
-        MiniMPZ rhs = other.m_Mantisse;
-
-        if (m_Exponant < other.m_Exponant) {
-            const int shift = other.m_Exponant - m_Exponant;
-            mpz_mul_2exp(rhs.get_mpz(), rhs.get_mpz(), static_cast<mp_bitcnt_t>(shift));
-        } else if (m_Exponant > other.m_Exponant) {
-            const int shift = m_Exponant - other.m_Exponant;
-            mpz_mul_2exp(lhs.get_mpz(), lhs.get_mpz(), static_cast<mp_bitcnt_t>(shift));
+        const mpz_t& a = m_Mantisse.get_mpz();
+        const mpz_t& b = other.m_Mantisse.get_mpz();
+        const long len_a = static_cast<long>(mpz_sizeinbase(a, 2)) + m_Exponant;
+        const long len_b = static_cast<long>(mpz_sizeinbase(b, 2)) + other.m_Exponant;
+        if (len_a != len_b) {
+            return (len_a > len_b) ? s1 : -s1;
         }
 
-        if (lhs > rhs) return 1;
-        if (lhs < rhs) return -1;
-        return 0;
+        const mp_size_t an = s1 > 0 ? a->_mp_size : -a->_mp_size;
+        const mp_size_t bn = s1 > 0 ? b->_mp_size : -b->_mp_size;
+        int cmp;
+        if (m_Exponant <= other.m_Exponant) {
+            cmp = mpn_cmplsh(a->_mp_d, an, b->_mp_d, bn, static_cast<mp_bitcnt_t>(other.m_Exponant - m_Exponant));
+        } else {
+            cmp = -mpn_cmplsh(b->_mp_d, bn, a->_mp_d, an, static_cast<mp_bitcnt_t>(m_Exponant - other.m_Exponant));
+        }
+        return s1 > 0 ? cmp : -cmp;
     }
 
     // Comparison operators
@@ -160,6 +352,7 @@ public:
     MiniMPF& operator+=(const MiniMPF& other) {
         if (MINI_GMP_PLUS_EXPECT(IsZero(), 0)) {
             *this = other;
+            apply_precision_limit();
             return *this;
         }
         if (MINI_GMP_PLUS_EXPECT(other.IsZero(), 0)) {
@@ -169,21 +362,14 @@ public:
         if (MINI_GMP_PLUS_EXPECT(m_Exponant == other.m_Exponant, 1)) {
             mpz_add(m_Mantisse.get_mpz(), m_Mantisse.get_mpz(), other.m_Mantisse.get_mpz());
         } else if (MINI_GMP_PLUS_EXPECT(m_Exponant < other.m_Exponant, 0)) {
-            // Scale other's mantissa up and add to this
-            mpz_t temp;
-            mpz_init(temp);
+            // Add other's mantissa, shifted on the fly
             const mp_bitcnt_t exp_diff = static_cast<mp_bitcnt_t>(other.m_Exponant - m_Exponant);
-            mpz_mul_2exp(temp, other.m_Mantisse.get_mpz(), exp_diff);
-            mpz_add(m_Mantisse.get_mpz(), m_Mantisse.get_mpz(), temp);
-            mpz_clear(temp);
+            mpz_addmul_2exp(m_Mantisse.get_mpz(), other.m_Mantisse.get_mpz(), exp_diff);
         } else {
-            // Scale this's mantissa up
-            mpz_t temp;
-            mpz_init(temp);
+            // Scale this's mantissa up in place
             const mp_bitcnt_t exp_diff = static_cast<mp_bitcnt_t>(m_Exponant - other.m_Exponant);
-            mpz_mul_2exp(temp, m_Mantisse.get_mpz(), exp_diff);
-            mpz_add(m_Mantisse.get_mpz(), temp, other.m_Mantisse.get_mpz());
-            mpz_clear(temp);
+            mpz_mul_2exp(m_Mantisse.get_mpz(), m_Mantisse.get_mpz(), exp_diff);
+            mpz_add(m_Mantisse.get_mpz(), m_Mantisse.get_mpz(), other.m_Mantisse.get_mpz());
             m_Exponant = other.m_Exponant;
         }
 
@@ -191,6 +377,7 @@ public:
         if (MINI_GMP_PLUS_EXPECT(mpz_even_p(m_Mantisse.get_mpz()), 0)) {
             normalize();
         }
+        apply_precision_limit();
         return *this;
     }
 
@@ -200,27 +387,21 @@ public:
         }
         if (MINI_GMP_PLUS_EXPECT(IsZero(), 0)) {
             *this = -other;
+            apply_precision_limit();
             return *this;
         }
 
         if (MINI_GMP_PLUS_EXPECT(m_Exponant == other.m_Exponant, 1)) {
             mpz_sub(m_Mantisse.get_mpz(), m_Mantisse.get_mpz(), other.m_Mantisse.get_mpz());
         } else if (MINI_GMP_PLUS_EXPECT(m_Exponant < other.m_Exponant, 0)) {
-            // Scale other's mantissa up and subtract from this
-            mpz_t temp;
-            mpz_init(temp);
+            // Subtract other's mantissa, shifted on the fly
             const mp_bitcnt_t exp_diff = static_cast<mp_bitcnt_t>(other.m_Exponant - m_Exponant);
-            mpz_mul_2exp(temp, other.m_Mantisse.get_mpz(), exp_diff);
-            mpz_sub(m_Mantisse.get_mpz(), m_Mantisse.get_mpz(), temp);
-            mpz_clear(temp);
+            mpz_submul_2exp(m_Mantisse.get_mpz(), other.m_Mantisse.get_mpz(), exp_diff);
         } else {
-            // Scale this's mantissa up
-            mpz_t temp;
-            mpz_init(temp);
+            // Scale this's mantissa up in place
             const mp_bitcnt_t exp_diff = static_cast<mp_bitcnt_t>(m_Exponant - other.m_Exponant);
-            mpz_mul_2exp(temp, m_Mantisse.get_mpz(), exp_diff);
-            mpz_sub(m_Mantisse.get_mpz(), temp, other.m_Mantisse.get_mpz());
-            mpz_clear(temp);
+            mpz_mul_2exp(m_Mantisse.get_mpz(), m_Mantisse.get_mpz(), exp_diff);
+            mpz_sub(m_Mantisse.get_mpz(), m_Mantisse.get_mpz(), other.m_Mantisse.get_mpz());
             m_Exponant = other.m_Exponant;
         }
 
@@ -228,6 +409,7 @@ public:
         if (MINI_GMP_PLUS_EXPECT(mpz_even_p(m_Mantisse.get_mpz()), 0)) {
             normalize();
         }
+        apply_precision_limit();
         return *this;
     }
 
@@ -240,6 +422,7 @@ public:
         }
         // Note: normalize not called because odd * odd = odd (no trailing zeros)
         // But this assumes both operands are normalized, which they should be
+        apply_precision_limit();
         return *this;
     }
 
@@ -266,133 +449,200 @@ public:
     }
 
     // FMA function (fused multiply-add): a * b + c
-    friend MiniMPF fma(const MiniMPF& a, const MiniMPF& b, const MiniMPF& c) {
-        MiniMPF result = a * b;
-        result += c;
+    // Under a precision limit, rounded once: a * b is kept exact.
+    // Defined after MiniMPFPrecisionScope, below.
+    friend MiniMPF fma(const MiniMPF& a, const MiniMPF& b, const MiniMPF& c);
+
+    // Thread-local precision limit: when bits > 0, the results of +, -, *,
+    // fma and the dot products are rounded to at most `bits` significant bits
+    // with the given rounding mode, so their cost stays constant over long
+    // computations. 0 (the default) keeps all arithmetic exact. Constructors,
+    // assignment and negation never round. See also MiniMPFPrecisionScope.
+    static void set_precision_limit(int bits, MiniMPFRounding rounding = MiniMPFRounding::ToNearest) {
+        if (bits < 0) {
+            throw std::invalid_argument("MiniMPF: precision limit must be >= 0");
+        }
+        precision_context() = MiniMPFPrecision{ bits, rounding };
+    }
+
+    static MiniMPFPrecision precision_limit() { return precision_context(); }
+
+    // Round in place to at most precision_bits significant bits.
+    void round_to_precision(int precision_bits, MiniMPFRounding rounding = MiniMPFRounding::ToNearest) {
+        check_precision(precision_bits);
+        if (IsZero()) {
+            return;
+        }
+        const bool negative = IsNegative();
+        mpz_abs(m_Mantisse.get_mpz(), m_Mantisse.get_mpz());
+        round_magnitude(m_Mantisse, m_Exponant, precision_bits, rounding, negative, false);
+        if (negative) {
+            mpz_neg(m_Mantisse.get_mpz(), m_Mantisse.get_mpz());
+        }
+        normalize();
+    }
+
+    // a / b rounded to precision_bits significant bits.
+    // The numerator is shifted so that the truncated quotient has at least
+    // precision_bits + 1 bits; the remainder then only acts as a sticky bit.
+    friend MiniMPF div(const MiniMPF& a, const MiniMPF& b, int precision_bits,
+                       MiniMPFRounding rounding = MiniMPFRounding::ToNearest) {
+        check_precision(precision_bits);
+        if (b.IsZero()) {
+            throw std::domain_error("MiniMPF: division by zero");
+        }
+        MiniMPF result;
+        if (a.IsZero()) {
+            return result;
+        }
+        const long bits_a = static_cast<long>(mpz_sizeinbase(a.m_Mantisse.get_mpz(), 2));
+        const long bits_b = static_cast<long>(mpz_sizeinbase(b.m_Mantisse.get_mpz(), 2));
+        const long shift = precision_bits + 1 + bits_b - bits_a;
+
+        MiniMPZ num, den, rem;
+        mpz_abs(num.get_mpz(), a.m_Mantisse.get_mpz());
+        mpz_abs(den.get_mpz(), b.m_Mantisse.get_mpz());
+        if (shift > 0) {
+            mpz_mul_2exp(num.get_mpz(), num.get_mpz(), static_cast<mp_bitcnt_t>(shift));
+        } else if (shift < 0) {
+            mpz_mul_2exp(den.get_mpz(), den.get_mpz(), static_cast<mp_bitcnt_t>(-shift));
+        }
+        mpz_tdiv_qr(result.m_Mantisse.get_mpz(), rem.get_mpz(), num.get_mpz(), den.get_mpz());
+        result.m_Exponant = a.m_Exponant - b.m_Exponant - static_cast<int>(shift);
+
+        const bool negative = a.Sign() != b.Sign();
+        round_magnitude(result.m_Mantisse, result.m_Exponant, precision_bits, rounding, negative, rem.sign() != 0);
+        if (negative) {
+            mpz_neg(result.m_Mantisse.get_mpz(), result.m_Mantisse.get_mpz());
+        }
+        result.normalize();
         return result;
     }
 
-    // FUSED DOT PRODUCT: avoids intermediate MiniMPF allocations
-    template<size_t N>
-    friend MiniMPF dot_product_fused(const std::array<MiniMPF, N>& a, const std::array<MiniMPF, N>& b) {
+    // sqrt(a) rounded to precision_bits significant bits, for a >= 0.
+    // The mantissa is shifted to an even exponent with at least
+    // 2 * (precision_bits + 1) bits, so the integer square root has
+    // precision_bits + 1 bits and its remainder acts as a sticky bit.
+    friend MiniMPF sqrt(const MiniMPF& a, int precision_bits,
+                        MiniMPFRounding rounding = MiniMPFRounding::ToNearest) {
+        check_precision(precision_bits);
+        if (a.IsNegative()) {
+            throw std::domain_error("MiniMPF: square root of a negative number");
+        }
         MiniMPF result;
-        mpz_mul(result.m_Mantisse.get_mpz(), a[0].m_Mantisse.get_mpz(), b[0].m_Mantisse.get_mpz());
-        result.m_Exponant = a[0].m_Exponant + b[0].m_Exponant;
-        for (size_t i = 1; i < N; ++i) {
-            mpz_t prod; mpz_init(prod);
-            mpz_mul(prod, a[i].m_Mantisse.get_mpz(), b[i].m_Mantisse.get_mpz());
-            int prod_exp = a[i].m_Exponant + b[i].m_Exponant;
-            const int exp_diff = result.m_Exponant - prod_exp;
-            if (exp_diff > 0) {
-                mpz_t scaled; mpz_init(scaled);
-                mpz_mul_2exp(scaled, prod, static_cast<mp_bitcnt_t>(exp_diff));
-                mpz_add(result.m_Mantisse.get_mpz(), result.m_Mantisse.get_mpz(), scaled);
-                mpz_clear(scaled);
-            } else if (exp_diff < 0) {
-                mpz_t scaled; mpz_init(scaled);
-                mpz_mul_2exp(scaled, result.m_Mantisse.get_mpz(), static_cast<mp_bitcnt_t>(-exp_diff));
-                result.m_Exponant = prod_exp;
-                mpz_set(result.m_Mantisse.get_mpz(), scaled);
-                mpz_add(result.m_Mantisse.get_mpz(), result.m_Mantisse.get_mpz(), prod);
-                mpz_clear(scaled);
-            } else {
-                mpz_add(result.m_Mantisse.get_mpz(), result.m_Mantisse.get_mpz(), prod);
-            }
-            mpz_clear(prod);
+        if (a.IsZero()) {
+            return result;
+        }
+        const long bits = static_cast<long>(mpz_sizeinbase(a.m_Mantisse.get_mpz(), 2));
+        long shift = 2L * (precision_bits + 1) - bits;
+        if (shift < 0) {
+            shift = 0;
+        }
+        if (((static_cast<long>(a.m_Exponant) - shift) & 1L) != 0) {
+            ++shift;
         }
+
+        MiniMPZ m, rem;
+        mpz_mul_2exp(m.get_mpz(), a.m_Mantisse.get_mpz(), static_cast<mp_bitcnt_t>(shift));
+        mpz_sqrtrem(result.m_Mantisse.get_mpz(), rem.get_mpz(), m.get_mpz());
+        result.m_Exponant = static_cast<int>((static_cast<long>(a.m_Exponant) - shift) / 2);
+
+        round_magnitude(result.m_Mantisse, result.m_Exponant, precision_bits, rounding, false, rem.sign() != 0);
         result.normalize();
         return result;
     }
 
-    // SIMD-INSPIRED DOT4 using 128-bit integers
-    // For the common case where all values have single-limb mantissas (from doubles)
-    // and equal exponents, we can use 128-bit integer arithmetic for speed.
-    // Falls back to fused version if conditions are not met or __uint128_t is unavailable.
-    friend MiniMPF dot_product_simd4(const std::array<MiniMPF, 4>& a, const std::array<MiniMPF, 4>& b) {
-        // Check if all exponents are equal
-        int ref_exp = a[0].m_Exponant + b[0].m_Exponant;
-        for (size_t i = 1; i < 4; ++i) {
-            if (a[i].m_Exponant + b[i].m_Exponant != ref_exp) {
-                return dot_product_fused(a, b);
+    // Sum of a[i] * b[i] for i < n, exact (rounded once under a precision
+    // limit). All products are accumulated into the result's limbs, sized
+    // once up front: product i is added at its bit offset from the smallest
+    // product exponent with mpn_addmul_1 / mpn_submul_1, the shift being
+    // applied on the fly to the limbs of b[i]. The accumulator is in two's
+    // complement with a spare top limb, so mixed signs need no comparison.
+    friend MiniMPF dot_product(const MiniMPF* a, const MiniMPF* b, size_t n) {
+        MiniMPF result;
+        if (n <= 16 && dot_product_small(a, b, n, result)) {
+            return result;
+        }
+        long min_exp = 0;
+        mp_size_t limbs = 0;
+        bool any = false;
+        for (size_t i = 0; i < n; ++i) {
+            if (a[i].IsZero() || b[i].IsZero()) {
+                continue;
             }
+            const long e = static_cast<long>(a[i].m_Exponant) + b[i].m_Exponant;
+            min_exp = any ? std::min(min_exp, e) : e;
+            any = true;
         }
-        
-        // Check if all mantissas are single-limb
-        for (size_t i = 0; i < 4; ++i) {
-            const mpz_t& ma = a[i].m_Mantisse.get_mpz();
-            const mpz_t& mb = b[i].m_Mantisse.get_mpz();
-            if (ma->_mp_size < -1 || ma->_mp_size > 1 || mb->_mp_size < -1 || mb->_mp_size > 1) {
-                return dot_product_fused(a, b);
+        if (!any) {
+            return result;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (a[i].IsZero() || b[i].IsZero()) {
+                continue;
             }
+            const long offset = static_cast<long>(a[i].m_Exponant) + b[i].m_Exponant - min_exp;
+            const mp_size_t top = static_cast<mp_size_t>(offset / 64) + 1
+                                + std::abs(a[i].m_Mantisse.get_mpz()->_mp_size)
+                                + std::abs(b[i].m_Mantisse.get_mpz()->_mp_size);
+            limbs = std::max(limbs, top);
         }
+        limbs += 1;  // carries of the n-term sum and the sign
 
-#if MINI_GMP_PLUS_HAS_UINT128
-        // Fast path: all single-limb, same exponent
-        // Products are 53x53=106 bits, sum is up to 106+2=108 bits
-        // Use 128-bit integer type to handle this precisely
-        MINI_GMP_PLUS_UINT128_T products[4];
-        int signs[4];  // 1 or -1 for each product's sign
-        
-        for (size_t i = 0; i < 4; ++i) {
+        mpz_t& acc_z = result.m_Mantisse.get_mpz();
+        const mp_ptr acc = mpz_limbs_write(acc_z, limbs);
+        mpn_zero(acc, limbs);
+        for (size_t i = 0; i < n; ++i) {
             const mpz_t& ma = a[i].m_Mantisse.get_mpz();
             const mpz_t& mb = b[i].m_Mantisse.get_mpz();
-            
-            uint64_t a_limb = ma->_mp_d[0];
-            uint64_t b_limb = mb->_mp_d[0];
-            
-            // Determine sign of product
-            bool a_neg = (ma->_mp_size < 0);
-            bool b_neg = (mb->_mp_size < 0);
-            signs[i] = (a_neg == b_neg) ? 1 : -1;
-            
-            // Multiply absolute values
-            products[i] = static_cast<MINI_GMP_PLUS_UINT128_T>(a_limb) * static_cast<MINI_GMP_PLUS_UINT128_T>(b_limb);
-        }
-        
-        // Sum absolute values of products
-        MINI_GMP_PLUS_UINT128_T abs_sum = products[0] + products[1] + products[2] + products[3];
-        
-        // Determine overall sign: XOR of all individual signs
-        // If odd number of negative products, result is negative
-        bool result_negative = false;
-        for (int s : signs) {
-            if (s < 0) result_negative = !result_negative;
-        }
-        
-        // Convert 128-bit result to MiniMPF
-        MiniMPF result;
-        result.m_Exponant = ref_exp;
-        
-        if (abs_sum == 0) {
-            result.m_Mantisse = MiniMPZ(0L);
-            result.m_Exponant = 0;
-        } else {
-            // Split 128-bit value into limbs for mpz_t
-            uint64_t lo = static_cast<uint64_t>(abs_sum);
-            uint64_t hi = static_cast<uint64_t>(abs_sum >> 64);
-            
-            mpz_t& m = result.m_Mantisse.get_mpz();
-            if (hi == 0) {
-                // Fits in single limb
-                m->_mp_size = result_negative ? -1 : 1;
-                m->_mp_d[0] = lo;
-            } else {
-                // Needs 2 limbs
-                // Check if it fits in the stack buffer
-                m->_mp_size = result_negative ? -2 : 2;
-                m->_mp_d[0] = lo;
-                m->_mp_d[1] = hi;
+            if (ma->_mp_size == 0 || mb->_mp_size == 0) {
+                continue;
             }
-            
-            // Normalize to remove trailing zeros
-            result.normalize();
+            const mp_size_t an = std::abs(ma->_mp_size);
+            const mp_size_t bn = std::abs(mb->_mp_size);
+            const bool negative = (ma->_mp_size < 0) != (mb->_mp_size < 0);
+            const long offset = static_cast<long>(a[i].m_Exponant) + b[i].m_Exponant - min_exp;
+            const mp_size_t q = static_cast<mp_size_t>(offset / 64);
+            const unsigned shift = static_cast<unsigned>(offset % 64);
+            for (mp_size_t j = 0; j <= bn; ++j) {
+                mp_limb_t v = j < bn ? mb->_mp_d[j] << shift : 0;
+                if (shift != 0 && j > 0) {
+                    v |= mb->_mp_d[j - 1] >> (64 - shift);
+                }
+                if (v == 0) {
+                    continue;
+                }
+                const mp_ptr rp = acc + q + j;
+                const mp_size_t rest = limbs - q - j - an;
+                if (negative) {
+                    propagate_borrow(rp + an, rest, mpn_submul_1(rp, ma->_mp_d, an, v));
+                } else {
+                    propagate_carry(rp + an, rest, mpn_addmul_1(rp, ma->_mp_d, an, v));
+                }
+            }
+        }
+
+        const bool negative = (acc[limbs - 1] >> 63) != 0;
+        if (negative) {
+            mpn_neg(acc, acc, limbs);
         }
-        
+        mpz_limbs_finish(acc_z, negative ? -limbs : limbs);
+        result.m_Exponant = static_cast<int>(min_exp);
+        result.normalize();
+        result.apply_precision_limit();
         return result;
-#else
-        // __uint128_t not available, fall back to fused implementation
-        return dot_product_fused(a, b);
-#endif
+    }
+
+    // FUSED DOT PRODUCT: avoids intermediate MiniMPF allocations
+    template<size_t N>
+    friend MiniMPF dot_product_fused(const std::array<MiniMPF, N>& a, const std::array<MiniMPF, N>& b) {
+        return dot_product(a.data(), b.data(), N);
+    }
+
+    // SIMD-INSPIRED DOT4: the n = 4 case of dot_product, which takes the
+    // 128-bit fast path (dot_product_small) for double-derived values.
+    friend MiniMPF dot_product_simd4(const std::array<MiniMPF, 4>& a, const std::array<MiniMPF, 4>& b) {
+        return dot_product(a.data(), b.data(), 4);
     }
 
     // Utility methods
@@ -450,33 +700,19 @@ public:
         return log_mant + m_Exponant;
     }
 
-     // Hash support
-     size_t hash() const {
-         if (IsZero()) {
-             std::hash<std::string> str_hash;
-             return str_hash("0") ^ (std::hash<int>()(0) << 1);
-         }
-         // Use canonical (normalized) representation so that mathematically
-         // equal values hash the same, even if they have different internal
-         // mantissa/exponent pairs (e.g. 1.0 from double ctor vs. 0.5+0.5).
-         mp_bitcnt_t trailing_zeros = mpz_scan1(m_Mantisse.get_mpz(), 0);
-         std::hash<std::string> str_hash;
-         if (trailing_zeros == 0) {
-             size_t h1 = str_hash(m_Mantisse.to_string());
-             size_t h2 = std::hash<int>()(m_Exponant);
-             return h1 ^ (h2 << 1);
-         }
-         mpz_t normalized;
-         mpz_init(normalized);
-         mpz_tdiv_q_2exp(normalized, m_Mantisse.get_mpz(), trailing_zeros);
-         char* cstr = mpz_get_str(nullptr, 10, normalized);
-         std::string normalized_str(cstr);
-         free(cstr);
-         mpz_clear(normalized);
-         size_t h1 = str_hash(normalized_str);
-         size_t h2 = std::hash<int>()(m_Exponant + static_cast<int>(trailing_zeros));
-         return h1 ^ (h2 << 1);
-     }
+    // Hash support
+    // Hashes the canonical value (odd mantissa, adjusted exponent), so that
+    // equal values hash the same even if one is not normalized (e.g. 1.0
+    // from the double constructor, mantissa 2^53). No allocation.
+    size_t hash() const {
+        if (IsZero()) {
+            return 0;
+        }
+        const mp_bitcnt_t trailing_zeros = mpz_scan1(m_Mantisse.get_mpz(), 0);
+        const long exponent = static_cast<long>(m_Exponant) + static_cast<long>(trailing_zeros);
+        const uint64_t h = static_cast<uint64_t>(m_Mantisse.hash(trailing_zeros));
+        return static_cast<size_t>(MiniMPZ::mix_hash(h ^ static_cast<uint64_t>(exponent)));
+    }
 
     // Stream output
     friend std::ostream& operator<<(std::ostream& os, const MiniMPF& num) {
@@ -484,6 +720,38 @@ public:
     }
 };
 
+// Sets the thread's MiniMPF precision limit for the lifetime of the scope and
+// restores the previous one on exit. MiniMPFPrecisionScope(0) makes the
+// arithmetic exact again, e.g. for code that relies on exact results.
+class MiniMPFPrecisionScope {
+public:
+    explicit MiniMPFPrecisionScope(int bits, MiniMPFRounding rounding = MiniMPFRounding::ToNearest)
+        : m_Saved(MiniMPF::precision_limit()) {
+        MiniMPF::set_precision_limit(bits, rounding);
+    }
+
+    ~MiniMPFPrecisionScope() {
+        MiniMPF::set_precision_limit(m_Saved.bits, m_Saved.rounding);
+    }
+
+    MiniMPFPrecisionScope(const MiniMPFPrecisionScope&) = delete;
+    MiniMPFPrecisionScope& operator=(const MiniMPFPrecisionScope&) = delete;
+
+private:
+    MiniMPFPrecision m_Saved;
+};
+
+inline MiniMPF fma(const MiniMPF& a, const MiniMPF& b, const MiniMPF& c) {
+    MiniMPF result;
+    {
+        MiniMPFPrecisionScope exact(0);
+        result = a * b;
+        result += c;
+    }
+    result.apply_precision_limit();
+    return result;
+}
+
 // std::hash specialization
 namespace std {
     template<> struct hash<MiniMPF> {
@@ -0,0 +1,376 @@
+// MiniMPFPredicates.hpp
+//
+// Filtered geometric predicates on double coordinates:
+//   orient2d(a, b, c)        > 0 if a, b, c are in counterclockwise order
+//   orient3d(a, b, c, d)     > 0 if d lies below the plane through a, b, c
+//                              (a, b, c counterclockwise seen from above)
+//   incircle(a, b, c, d)     > 0 if d lies inside the circle through the
+//                              counterclockwise points a, b, c
+//   insphere(a, b, c, d, e)  > 0 if e lies inside the sphere through a, b, c, d
+//                              (orient3d(a, b, c, d) > 0)
+// Each returns the sign of the determinant: -1, 0 or 1.  Points are pointers
+// to 2 or 3 consecutive doubles, with the same conventions as Shewchuk's
+// predicates.c.
+//
+// Every predicate first evaluates the determinant in double and compares it
+// with a semi-static error bound, eps-multiple * permanent, where the
+// permanent is the same expression with all terms replaced by their absolute
+// values (bounds from Shewchuk, "Adaptive Precision Floating-Point Arithmetic
+// and Fast Robust Geometric Predicates", stage A).  Only when the rounded
+// determinant is within the bound is it recomputed exactly with MiniMPF,
+// which is rare for non-degenerate input.  The *_filter functions expose the
+// first stage alone, the *_exact functions the last one.
+//
+// orient2d and orient3d have an intermediate stage, *_expansion, which
+// evaluates the determinant exactly with floating-point expansions
+// (Expansion.hpp) on the stack.  It declines inputs whose coordinates are
+// outside [2^-200, 2^200] (zero aside), where the expansion arithmetic could
+// underflow or overflow; those go to MiniMPF.  orient3d_batch runs
+// the filter over structure-of-arrays buffers (vectorized in SIMD builds) and
+// then resolves the uncertain entries exactly.
+//
+// As in predicates.c, the filter assumes that no intermediate value
+// underflows.  Overflow or NaN never passes the filter.  The exact stage
+// requires finite coordinates; it ignores any MiniMPF precision limit.
+
+#ifndef MINIMPFPREDICATES_HPP
+#define MINIMPFPREDICATES_HPP
+
+#include "Expansion.hpp"
+#include "MiniMPF.hpp"
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+namespace mini_gmp_plus_predicates {
+
+namespace detail {
+
+// Half an ulp of 1.0: |fl(x) - x| <= epsilon * |x| for double rounding.
+constexpr double epsilon = 1.1102230246251565e-16;  // 2^-53
+
+constexpr double ccwerrboundA = (3.0 + 16.0 * epsilon) * epsilon;
+constexpr double o3derrboundA = (7.0 + 56.0 * epsilon) * epsilon;
+constexpr double iccerrboundA = (10.0 + 96.0 * epsilon) * epsilon;
+constexpr double isperrboundA = (16.0 + 224.0 * epsilon) * epsilon;
+
+// Decide the sign of `det` if it is farther from zero than `errbound`.
+inline bool certain_sign(double det, double errbound, int& sign) {
+    if (det > errbound) {
+        sign = 1;
+        return true;
+    }
+    if (-det > errbound) {
+        sign = -1;
+        return true;
+    }
+    return false;
+}
+
+// Coordinates for which expansion arithmetic on determinants of degree <= 3
+// is exact: every intermediate value is a multiple of 2^-756 (no underflow)
+// and below 2^700 (no overflow).
+inline bool expansion_safe(const double* p, int n) {
+    const double lo = 6.2230152778611417e-61;   // 2^-200
+    const double hi = 1.6069380442589903e+60;   // 2^200
+    for (int i = 0; i < n; ++i) {
+        const double a = std::fabs(p[i]);
+        if (a != 0.0 && !(a >= lo && a <= hi)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline MiniMPF exact(double x) {
+    if (!std::isfinite(x)) {
+        throw std::invalid_argument("mini_gmp_plus_predicates: coordinates must be finite");
+    }
+    return MiniMPF(x);
+}
+
+// a * b - c * d, exactly
+inline MiniMPF cross(const MiniMPF& a, const MiniMPF& b, const MiniMPF& c, const MiniMPF& d) {
+    MiniMPF r = a * b;
+    r -= c * d;
+    return r;
+}
+
+inline MiniMPF lift(const MiniMPF& x, const MiniMPF& y) {
+    MiniMPF r = x * x;
+    r += y * y;
+    return r;
+}
+
+inline MiniMPF lift(const MiniMPF& x, const MiniMPF& y, const MiniMPF& z) {
+    MiniMPF r = lift(x, y);
+    r += z * z;
+    return r;
+}
+
+} // namespace detail
+
+// --- orient2d ------------------------------------------------------------
+
+inline bool orient2d_filter(const double* pa, const double* pb, const double* pc, int& sign) {
+    const double detleft = (pa[0] - pc[0]) * (pb[1] - pc[1]);
+    const double detright = (pa[1] - pc[1]) * (pb[0] - pc[0]);
+    const double det = detleft - detright;
+    const double detsum = std::fabs(detleft) + std::fabs(detright);
+    return detail::certain_sign(det, detail::ccwerrboundA * detsum, sign);
+}
+
+inline int orient2d_exact(const double* pa, const double* pb, const double* pc) {
+    const MiniMPFPrecisionScope exact_arithmetic(0);
+    const MiniMPF cx = detail::exact(pc[0]), cy = detail::exact(pc[1]);
+    const MiniMPF acx = detail::exact(pa[0]) - cx, acy = detail::exact(pa[1]) - cy;
+    const MiniMPF bcx = detail::exact(pb[0]) - cx, bcy = detail::exact(pb[1]) - cy;
+    return detail::cross(acx, bcy, acy, bcx).Sign();
+}
+
+inline bool orient2d_expansion(const double* pa, const double* pb, const double* pc, int& sign) {
+    if (!detail::expansion_safe(pa, 2) || !detail::expansion_safe(pb, 2) || !detail::expansion_safe(pc, 2)) {
+        return false;
+    }
+    const Expansion<2> acx = Expansion<2>::from_diff(pa[0], pc[0]), acy = Expansion<2>::from_diff(pa[1], pc[1]);
+    const Expansion<2> bcx = Expansion<2>::from_diff(pb[0], pc[0]), bcy = Expansion<2>::from_diff(pb[1], pc[1]);
+    sign = difference(product(acx, bcy), product(acy, bcx)).sign();
+    return true;
+}
+
+inline int orient2d(const double* pa, const double* pb, const double* pc) {
+    int sign = 0;
+    if (orient2d_filter(pa, pb, pc, sign) || orient2d_expansion(pa, pb, pc, sign)) {
+        return sign;
+    }
+    return orient2d_exact(pa, pb, pc);
+}
+
+// --- orient3d ------------------------------------------------------------
+
+inline bool orient3d_filter(const double* pa, const double* pb, const double* pc, const double* pd, int& sign) {
+    const double adx = pa[0] - pd[0], ady = pa[1] - pd[1], adz = pa[2] - pd[2];
+    const double bdx = pb[0] - pd[0], bdy = pb[1] - pd[1], bdz = pb[2] - pd[2];
+    const double cdx = pc[0] - pd[0], cdy = pc[1] - pd[1], cdz = pc[2] - pd[2];
+
+    const double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    const double cdxady = cdx * ady, adxcdy = adx * cdy;
+    const double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+    const double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+    const double permanent = (std::fabs(bdxcdy) + std::fabs(cdxbdy)) * std::fabs(adz)
+                           + (std::fabs(cdxady) + std::fabs(adxcdy)) * std::fabs(bdz)
+                           + (std::fabs(adxbdy) + std::fabs(bdxady)) * std::fabs(cdz);
+    return detail::certain_sign(det, detail::o3derrboundA * permanent, sign);
+}
+
+inline int orient3d_exact(const double* pa, const double* pb, const double* pc, const double* pd) {
+    const MiniMPFPrecisionScope exact_arithmetic(0);
+    const MiniMPF dx = detail::exact(pd[0]), dy = detail::exact(pd[1]), dz = detail::exact(pd[2]);
+    const MiniMPF adx = detail::exact(pa[0]) - dx, ady = detail::exact(pa[1]) - dy, adz = detail::exact(pa[2]) - dz;
+    const MiniMPF bdx = detail::exact(pb[0]) - dx, bdy = detail::exact(pb[1]) - dy, bdz = detail::exact(pb[2]) - dz;
+    const MiniMPF cdx = detail::exact(pc[0]) - dx, cdy = detail::exact(pc[1]) - dy, cdz = detail::exact(pc[2]) - dz;
+
+    MiniMPF det = adz * detail::cross(bdx, cdy, cdx, bdy);
+    det += bdz * detail::cross(cdx, ady, adx, cdy);
+    det += cdz * detail::cross(adx, bdy, bdx, ady);
+    return det.Sign();
+}
+
+inline bool orient3d_expansion(const double* pa, const double* pb, const double* pc, const double* pd, int& sign) {
+    if (!detail::expansion_safe(pa, 3) || !detail::expansion_safe(pb, 3) ||
+        !detail::expansion_safe(pc, 3) || !detail::expansion_safe(pd, 3)) {
+        return false;
+    }
+    typedef Expansion<2> E2;
+    const E2 adx = E2::from_diff(pa[0], pd[0]), ady = E2::from_diff(pa[1], pd[1]), adz = E2::from_diff(pa[2], pd[2]);
+    const E2 bdx = E2::from_diff(pb[0], pd[0]), bdy = E2::from_diff(pb[1], pd[1]), bdz = E2::from_diff(pb[2], pd[2]);
+    const E2 cdx = E2::from_diff(pc[0], pd[0]), cdy = E2::from_diff(pc[1], pd[1]), cdz = E2::from_diff(pc[2], pd[2]);
+
+    Expansion<16> bc = difference(product(bdx, cdy), product(cdx, bdy));
+    Expansion<16> ca = difference(product(cdx, ady), product(adx, cdy));
+    Expansion<16> ab = difference(product(adx, bdy), product(bdx, ady));
+    bc.compress();
+    ca.compress();
+    ab.compress();
+    sign = sum(sum(product(bc, adz), product(ca, bdz)), product(ab, cdz)).sign();
+    return true;
+}
+
+inline int orient3d(const double* pa, const double* pb, const double* pc, const double* pd) {
+    int sign = 0;
+    if (orient3d_filter(pa, pb, pc, pd, sign) || orient3d_expansion(pa, pb, pc, pd, sign)) {
+        return sign;
+    }
+    return orient3d_exact(pa, pb, pc, pd);
+}
+
+// --- incircle ------------------------------------------------------------
+
+inline bool incircle_filter(const double* pa, const double* pb, const double* pc, const double* pd, int& sign) {
+    const double adx = pa[0] - pd[0], ady = pa[1] - pd[1];
+    const double bdx = pb[0] - pd[0], bdy = pb[1] - pd[1];
+    const double cdx = pc[0] - pd[0], cdy = pc[1] - pd[1];
+
+    const double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    const double alift = adx * adx + ady * ady;
+    const double cdxady = cdx * ady, adxcdy = adx * cdy;
+    const double blift = bdx * bdx + bdy * bdy;
+    const double adxbdy = adx * bdy, bdxady = bdx * ady;
+    const double clift = cdx * cdx + cdy * cdy;
+
+    const double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+    const double permanent = (std::fabs(bdxcdy) + std::fabs(cdxbdy)) * alift
+                           + (std::fabs(cdxady) + std::fabs(adxcdy)) * blift
+                           + (std::fabs(adxbdy) + std::fabs(bdxady)) * clift;
+    return detail::certain_sign(det, detail::iccerrboundA * permanent, sign);
+}
+
+inline int incircle_exact(const double* pa, const double* pb, const double* pc, const double* pd) {
+    const MiniMPFPrecisionScope exact_arithmetic(0);
+    const MiniMPF dx = detail::exact(pd[0]), dy = detail::exact(pd[1]);
+    const MiniMPF adx = detail::exact(pa[0]) - dx, ady = detail::exact(pa[1]) - dy;
+    const MiniMPF bdx = detail::exact(pb[0]) - dx, bdy = detail::exact(pb[1]) - dy;
+    const MiniMPF cdx = detail::exact(pc[0]) - dx, cdy = detail::exact(pc[1]) - dy;
+
+    MiniMPF det = detail::lift(adx, ady) * detail::cross(bdx, cdy, cdx, bdy);
+    det += detail::lift(bdx, bdy) * detail::cross(cdx, ady, adx, cdy);
+    det += detail::lift(cdx, cdy) * detail::cross(adx, bdy, bdx, ady);
+    return det.Sign();
+}
+
+inline int incircle(const double* pa, const double* pb, const double* pc, const double* pd) {
+    int sign = 0;
+    if (incircle_filter(pa, pb, pc, pd, sign)) {
+        return sign;
+    }
+    return incircle_exact(pa, pb, pc, pd);
+}
+
+// --- insphere ------------------------------------------------------------
+
+inline bool insphere_filter(const double* pa, const double* pb, const double* pc, const double* pd,
+                            const double* pe, int& sign) {
+    const double aex = pa[0] - pe[0], aey = pa[1] - pe[1], aez = pa[2] - pe[2];
+    const double bex = pb[0] - pe[0], bey = pb[1] - pe[1], bez = pb[2] - pe[2];
+    const double cex = pc[0] - pe[0], cey = pc[1] - pe[1], cez = pc[2] - pe[2];
+    const double dex = pd[0] - pe[0], dey = pd[1] - pe[1], dez = pd[2] - pe[2];
+
+    const double aexbey = aex * bey, bexaey = bex * aey;
+    const double bexcey = bex * cey, cexbey = cex * bey;
+    const double cexdey = cex * dey, dexcey = dex * cey;
+    const double dexaey = dex * aey, aexdey = aex * dey;
+    const double aexcey = aex * cey, cexaey = cex * aey;
+    const double bexdey = bex * dey, dexbey = dex * bey;
+
+    const double ab = aexbey - bexaey, bc = bexcey - cexbey;
+    const double cd = cexdey - dexcey, da = dexaey - aexdey;
+    const double ac = aexcey - cexaey, bd = bexdey - dexbey;
+
+    const double abc = aez * bc - bez * ac + cez * ab;
+    const double bcd = bez * cd - cez * bd + dez * bc;
+    const double cda = cez * da + dez * ac + aez * cd;
+    const double dab = dez * ab + aez * bd + bez * da;
+
+    const double alift = aex * aex + aey * aey + aez * aez;
+    const double blift = bex * bex + bey * bey + bez * bez;
+    const double clift = cex * cex + cey * cey + cez * cez;
+    const double dlift = dex * dex + dey * dey + dez * dez;
+
+    const double det = (dlift * abc - clift * dab) + (blift * cda - alift * bcd);
+
+    const double aezplus = std::fabs(aez), bezplus = std::fabs(bez);
+    const double cezplus = std::fabs(cez), dezplus = std::fabs(dez);
+    const double abplus = std::fabs(aexbey) + std::fabs(bexaey);
+    const double bcplus = std::fabs(bexcey) + std::fabs(cexbey);
+    const double cdplus = std::fabs(cexdey) + std::fabs(dexcey);
+    const double daplus = std::fabs(dexaey) + std::fabs(aexdey);
+    const double acplus = std::fabs(aexcey) + std::fabs(cexaey);
+    const double bdplus = std::fabs(bexdey) + std::fabs(dexbey);
+    const double permanent = (cdplus * bezplus + bdplus * cezplus + bcplus * dezplus) * alift
+                           + (daplus * cezplus + acplus * dezplus + cdplus * aezplus) * blift
+                           + (abplus * dezplus + bdplus * aezplus + daplus * bezplus) * clift
+                           + (bcplus * aezplus + acplus * bezplus + abplus * cezplus) * dlift;
+    return detail::certain_sign(det, detail::isperrboundA * permanent, sign);
+}
+
+inline int insphere_exact(const double* pa, const double* pb, const double* pc, const double* pd,
+                          const double* pe) {
+    const MiniMPFPrecisionScope exact_arithmetic(0);
+    const MiniMPF ex = detail::exact(pe[0]), ey = detail::exact(pe[1]), ez = detail::exact(pe[2]);
+    const MiniMPF aex = detail::exact(pa[0]) - ex, aey = detail::exact(pa[1]) - ey, aez = detail::exact(pa[2]) - ez;
+    const MiniMPF bex = detail::exact(pb[0]) - ex, bey = detail::exact(pb[1]) - ey, bez = detail::exact(pb[2]) - ez;
+    const MiniMPF cex = detail::exact(pc[0]) - ex, cey = detail::exact(pc[1]) - ey, cez = detail::exact(pc[2]) - ez;
+    const MiniMPF dex = detail::exact(pd[0]) - ex, dey = detail::exact(pd[1]) - ey, dez = detail::exact(pd[2]) - ez;
+
+    const MiniMPF ab = detail::cross(aex, bey, bex, aey), bc = detail::cross(bex, cey, cex, bey);
+    const MiniMPF cd = detail::cross(cex, dey, dex, cey), da = detail::cross(dex, aey, aex, dey);
+    const MiniMPF ac = detail::cross(aex, cey, cex, aey), bd = detail::cross(bex, dey, dex, bey);
+
+    MiniMPF abc = aez * bc;
+    abc -= bez * ac;
+    abc += cez * ab;
+    MiniMPF bcd = bez * cd;
+    bcd -= cez * bd;
+    bcd += dez * bc;
+    MiniMPF cda = cez * da;
+    cda += dez * ac;
+    cda += aez * cd;
+    MiniMPF dab = dez * ab;
+    dab += aez * bd;
+    dab += bez * da;
+
+    MiniMPF det = detail::lift(dex, dey, dez) * abc;
+    det -= detail::lift(cex, cey, cez) * dab;
+    det += detail::lift(bex, bey, bez) * cda;
+    det -= detail::lift(aex, aey, aez) * bcd;
+    return det.Sign();
+}
+
+inline int insphere(const double* pa, const double* pb, const double* pc, const double* pd, const double* pe) {
+    int sign = 0;
+    if (insphere_filter(pa, pb, pc, pd, pe, sign)) {
+        return sign;
+    }
+    return insphere_exact(pa, pb, pc, pd, pe);
+}
+
+// --- Batched orient3d ----------------------------------------------------
+
+// Structure-of-arrays input: quadruple i is (ax[i], ay[i], az[i]),
+// (bx[i], by[i], bz[i]), (cx[i], cy[i], cz[i]), (dx[i], dy[i], dz[i]).
+struct Orient3dBatch {
+    const double* ax; const double* ay; const double* az;
+    const double* bx; const double* by; const double* bz;
+    const double* cx; const double* cy; const double* cz;
+    const double* dx; const double* dy; const double* dz;
+    std::size_t count;
+};
+
+// Filter stage over the whole batch, compiled into the library so SIMD
+// builds run it across xsimd::batch<double> lanes. Writes the sign of every
+// certain quadruple to signs[i] (0 for uncertain ones), stores the indices
+// of the uncertain quadruples in increasing order in uncertain[] (room for
+// `count` entries) and returns how many there are.
+MINI_GMP_PLUS_API std::size_t orient3d_filter_batch(const Orient3dBatch& batch, int* signs, std::size_t* uncertain);
+
+// Filter, then resolve the uncertain quadruples exactly (expansion stage,
+// then MiniMPF).
+// `uncertain` is scratch space for `count` indices.
+inline void orient3d_batch(const Orient3dBatch& batch, int* signs, std::size_t* uncertain) {
+    const std::size_t n = orient3d_filter_batch(batch, signs, uncertain);
+    for (std::size_t k = 0; k < n; ++k) {
+        const std::size_t i = uncertain[k];
+        const double pa[3] = { batch.ax[i], batch.ay[i], batch.az[i] };
+        const double pb[3] = { batch.bx[i], batch.by[i], batch.bz[i] };
+        const double pc[3] = { batch.cx[i], batch.cy[i], batch.cz[i] };
+        const double pd[3] = { batch.dx[i], batch.dy[i], batch.dz[i] };
+        if (!orient3d_expansion(pa, pb, pc, pd, signs[i])) {
+            signs[i] = orient3d_exact(pa, pb, pc, pd);
+        }
+    }
+}
+
+} // namespace mini_gmp_plus_predicates
+
+#endif // MINIMPFPREDICATES_HPP
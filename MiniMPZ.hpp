@@ -3,9 +3,13 @@
 #define MINIMPZ_HPP
 
 #include "mini-gmp.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <stdexcept>
 #include <ostream>
+#include <utility>
 
 class MiniMPZ {
 private:
@@ -39,15 +43,21 @@ public:
     // Copy constructor
     MiniMPZ(const MiniMPZ& other) { mpz_init_set(value_, other.value_); }
 
-    // Move constructor
+    // Move constructor: steals the limbs and leaves other as zero.
+    // With the local buffer, this is done inline without calling into the
+    // C library (the common case when std::vector reallocates or sorts).
     MiniMPZ(MiniMPZ&& other) noexcept {
         *value_ = *other.value_;
 #ifdef MINI_GMP_PLUS_BUFF_SIZE
         if (other.value_->_mp_d == other.value_->_mp_buff) {
             value_->_mp_d = value_->_mp_buff;
         }
-#endif
+        other.value_->_mp_alloc = MINI_GMP_PLUS_BUFF_SIZE;
+        other.value_->_mp_size = 0;
+        other.value_->_mp_d = other.value_->_mp_buff;
+#else
         mpz_init(other.value_);
+#endif
     }
 
     // Destructor
@@ -61,21 +71,39 @@ public:
         return *this;
     }
 
-    // Move assignment
+    // Move assignment: swaps storage, then zeroes other. Any heap limbs
+    // previously owned by *this are released when other is destroyed.
     MiniMPZ& operator=(MiniMPZ&& other) noexcept {
         if (this != &other) {
-            mpz_clear(value_);
-            *value_ = *other.value_;
-#ifdef MINI_GMP_PLUS_BUFF_SIZE
-            if (other.value_->_mp_d == other.value_->_mp_buff) {
-                value_->_mp_d = value_->_mp_buff;
-            }
-#endif
-            mpz_init(other.value_);
+            swap(other);
+            other.value_->_mp_size = 0;
         }
         return *this;
     }
 
+    // Swap without calling into the C library. Values stored in the local
+    // buffer are exchanged along with the struct, then _mp_d is redirected
+    // to the buffer of the object that now owns it.
+    void swap(MiniMPZ& other) noexcept {
+        const __mpz_struct tmp = *value_;
+        *value_ = *other.value_;
+        *other.value_ = tmp;
+#ifdef MINI_GMP_PLUS_BUFF_SIZE
+        if (value_->_mp_d == other.value_->_mp_buff) {
+            value_->_mp_d = value_->_mp_buff;
+        }
+        if (other.value_->_mp_d == value_->_mp_buff) {
+            other.value_->_mp_d = other.value_->_mp_buff;
+        }
+#endif
+    }
+
+    // Found by ADL, so `using std::swap; swap(a, b);` and the standard
+    // algorithms use the member swap above.
+    friend void swap(MiniMPZ& a, MiniMPZ& b) noexcept {
+        a.swap(b);
+    }
+
     // Arithmetic operators
     MiniMPZ operator+(const MiniMPZ& other) const {
         MiniMPZ result;
@@ -203,6 +231,42 @@ public:
 
     bool is_odd() const { return mpz_odd_p(value_); }
 
+    // Hash of the value, mixed directly from the limbs (no allocation).
+    // hash(k) hashes *this / 2^k for a value whose k low bits are zero, so
+    // that MiniMPF can hash its normalized mantissa without computing it.
+    std::size_t hash(mp_bitcnt_t low_zero_bits = 0) const {
+        const unsigned limb_bits = 64;  // mp_limb_t is uint64_t
+        const mp_size_t limbs = static_cast<mp_size_t>(low_zero_bits / limb_bits);
+        const unsigned shift = static_cast<unsigned>(low_zero_bits % limb_bits);
+        const mp_size_t size = value_->_mp_size < 0 ? -value_->_mp_size : value_->_mp_size;
+        const mp_srcptr d = value_->_mp_d + limbs;
+        const mp_size_t n = size - limbs;
+        uint64_t h = mix_hash(0x9e3779b97f4a7c15ULL ^ static_cast<uint64_t>(mpz_sgn(value_) + 1));
+        for (mp_size_t i = 0; i < n; ++i) {
+            uint64_t limb = d[i];
+            if (shift != 0) {
+                limb >>= shift;
+                if (i + 1 < n) {
+                    limb |= d[i + 1] << (limb_bits - shift);
+                }
+            }
+            if (limb != 0 || i + 1 < n) {
+                h = mix_hash(h ^ limb);
+            }
+        }
+        return static_cast<std::size_t>(h);
+    }
+
+    // Avalanching 64-bit mix (the splitmix64 finalizer)
+    static uint64_t mix_hash(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+
     // Stream output
     friend std::ostream& operator<<(std::ostream& os, const MiniMPZ& num) {
         return os << num.to_string();
@@ -213,4 +277,13 @@ public:
     const mpz_t& get_mpz() const { return value_; }
 };
 
+// std::hash specialization
+namespace std {
+    template<> struct hash<MiniMPZ> {
+        size_t operator()(const MiniMPZ& val) const {
+            return val.hash();
+        }
+    };
+}
+
 #endif // MINIMPZ_HPP
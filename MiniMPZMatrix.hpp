@@ -0,0 +1,202 @@
+// MiniMPZMatrix.hpp
+//
+// MiniMPZMatrix: dense integer matrix with exact determinant, rank and
+// linear solve based on Bareiss fraction-free Gaussian elimination.
+//
+// Cofactor expansion (see tests/geometry_workloads.hpp) costs O(n!) and is
+// only usable up to 4x4.  Bareiss elimination is O(n^3) and keeps every
+// intermediate entry an integer: after step k, entry (i,j) is the (k+1)x(k+1)
+// leading minor bordered by row i and column j, obtained as
+//
+//     a[i][j] = (a[i][j] * a[k][k] - a[i][k] * a[k][j]) / a[k-1][k-1]
+//
+// where the division is exact.  Each update runs in place on the entry with
+// mpz_mul, mpz_submul and mpz_divexact, so no temporary MiniMPZ is created.
+//
+// Entries are stored row-major in one contiguous std::vector<MiniMPZ>.
+
+#ifndef MINIMPZMATRIX_HPP
+#define MINIMPZMATRIX_HPP
+
+#include "mini-gmp.h"
+#include "MiniMPZ.hpp"
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+class MiniMPZMatrix {
+private:
+    std::size_t rows_{};
+    std::size_t cols_{};
+    std::vector<MiniMPZ> data_;
+
+    void swap_rows(std::size_t r1, std::size_t r2) {
+        for (std::size_t j = 0; j < cols_; ++j) {
+            (*this)(r1, j).swap((*this)(r2, j));
+        }
+    }
+
+    // One Bareiss step: eliminate column `col` below row `row` using the
+    // pivot at (row, col), for columns col+1 .. cols_-1. `prev` is the
+    // previous pivot (nullptr stands for 1).
+    void bareiss_step(std::size_t row, std::size_t col, const MiniMPZ* prev) {
+        const mpz_t& pivot = (*this)(row, col).get_mpz();
+        for (std::size_t i = row + 1; i < rows_; ++i) {
+            const mpz_t& factor = (*this)(i, col).get_mpz();
+            for (std::size_t j = col + 1; j < cols_; ++j) {
+                mpz_t& a = (*this)(i, j).get_mpz();
+                mpz_mul(a, a, pivot);
+                mpz_submul(a, factor, (*this)(row, j).get_mpz());
+                if (prev != nullptr) {
+                    mpz_divexact(a, a, prev->get_mpz());
+                }
+            }
+            mpz_set_ui((*this)(i, col).get_mpz(), 0);
+        }
+    }
+
+    // Fraction-free row echelon form, in place. Returns the rank and sets
+    // `swaps` to the number of row exchanges. When `square_only` is set,
+    // elimination stops at the first column without a pivot (the matrix is
+    // singular, which is all a determinant needs to know).
+    std::size_t echelonize(std::size_t pivot_cols, bool square_only, std::size_t& swaps) {
+        swaps = 0;
+        std::size_t row = 0;
+        const MiniMPZ* prev = nullptr;
+        for (std::size_t col = 0; col < pivot_cols && row < rows_; ++col) {
+            std::size_t p = row;
+            while (p < rows_ && (*this)(p, col).sign() == 0) {
+                ++p;
+            }
+            if (p == rows_) {
+                if (square_only) {
+                    return row;
+                }
+                continue;
+            }
+            if (p != row) {
+                swap_rows(p, row);
+                ++swaps;
+            }
+            bareiss_step(row, col, prev);
+            prev = &(*this)(row, col);
+            ++row;
+        }
+        return row;
+    }
+
+public:
+    // Constructors
+    MiniMPZMatrix() = default;
+
+    MiniMPZMatrix(std::size_t rows, std::size_t cols) : rows_(rows), cols_(cols), data_(rows * cols) {}
+
+    // Dimensions
+    std::size_t rows() const { return rows_; }
+    std::size_t cols() const { return cols_; }
+
+    // Element access (row-major)
+    MiniMPZ& operator()(std::size_t i, std::size_t j) { return data_[i * cols_ + j]; }
+    const MiniMPZ& operator()(std::size_t i, std::size_t j) const { return data_[i * cols_ + j]; }
+
+    MiniMPZ& at(std::size_t i, std::size_t j) {
+        if (i >= rows_ || j >= cols_) {
+            throw std::out_of_range("MiniMPZMatrix index out of range");
+        }
+        return (*this)(i, j);
+    }
+
+    const MiniMPZ& at(std::size_t i, std::size_t j) const {
+        if (i >= rows_ || j >= cols_) {
+            throw std::out_of_range("MiniMPZMatrix index out of range");
+        }
+        return (*this)(i, j);
+    }
+
+    // Pointer to the first entry of row i (cols() consecutive entries).
+    MiniMPZ* row(std::size_t i) { return data_.data() + i * cols_; }
+    const MiniMPZ* row(std::size_t i) const { return data_.data() + i * cols_; }
+
+    // Exact determinant (square matrices only).
+    MiniMPZ determinant() const {
+        if (rows_ != cols_) {
+            throw std::invalid_argument("MiniMPZMatrix::determinant requires a square matrix");
+        }
+        if (rows_ == 0) {
+            return MiniMPZ(1L);
+        }
+        MiniMPZMatrix work(*this);
+        std::size_t swaps = 0;
+        if (work.echelonize(cols_, true, swaps) < rows_) {
+            return MiniMPZ(0L);
+        }
+        MiniMPZ result(std::move(work(rows_ - 1, cols_ - 1)));
+        if ((swaps & 1U) != 0U) {
+            mpz_neg(result.get_mpz(), result.get_mpz());
+        }
+        return result;
+    }
+
+    // Exact rank (any shape).
+    std::size_t rank() const {
+        MiniMPZMatrix work(*this);
+        std::size_t swaps = 0;
+        return work.echelonize(cols_, false, swaps);
+    }
+
+    // Solve A x = b for square non-singular A. The solution is returned as
+    // integer numerators x[i] over a common positive denominator: the true
+    // solution is x[i] / denominator, with denominator = |det(A)|.
+    // Returns false (leaving x and denominator untouched) if A is singular.
+    bool solve(const std::vector<MiniMPZ>& b, std::vector<MiniMPZ>& x, MiniMPZ& denominator) const {
+        if (rows_ != cols_ || b.size() != rows_) {
+            throw std::invalid_argument("MiniMPZMatrix::solve requires a square matrix and a matching right-hand side");
+        }
+        const std::size_t n = rows_;
+        if (n == 0) {
+            x.clear();
+            denominator = MiniMPZ(1L);
+            return true;
+        }
+
+        // Forward elimination on the augmented matrix [A | b].
+        MiniMPZMatrix work(n, n + 1);
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j < n; ++j) {
+                work(i, j) = (*this)(i, j);
+            }
+            work(i, n) = b[i];
+        }
+        std::size_t swaps = 0;
+        if (work.echelonize(n, true, swaps) < n) {
+            return false;
+        }
+
+        // Fraction-free back substitution. With d the last pivot, d * x[i] is
+        // an integer y[i] and U[i][i] * y[i] = d * c[i] - sum_{j>i} U[i][j] * y[j],
+        // so the division by U[i][i] is exact.
+        const MiniMPZ& d = work(n - 1, n - 1);
+        std::vector<MiniMPZ> y(n);
+        y[n - 1] = work(n - 1, n);
+        for (std::size_t k = n - 1; k-- > 0;) {
+            mpz_t& yk = y[k].get_mpz();
+            mpz_mul(yk, d.get_mpz(), work(k, n).get_mpz());
+            for (std::size_t j = k + 1; j < n; ++j) {
+                mpz_submul(yk, work(k, j).get_mpz(), y[j].get_mpz());
+            }
+            mpz_divexact(yk, yk, work(k, k).get_mpz());
+        }
+
+        if (d.sign() < 0) {
+            for (std::size_t i = 0; i < n; ++i) {
+                mpz_neg(y[i].get_mpz(), y[i].get_mpz());
+            }
+        }
+        denominator = d.abs();
+        x.swap(y);
+        return true;
+    }
+};
+
+#endif // MINIMPZMATRIX_HPP
@@ -0,0 +1,482 @@
+// MiniMPZModular.hpp
+//
+// Multi-modular exact linear algebra on MiniMPZMatrix.
+//
+// Bareiss elimination (MiniMPZMatrix::determinant) performs O(n^3) big-number
+// operations whose operands grow to the size of the result.  The
+// multi-modular path instead:
+//   1. bounds the result with Hadamard's inequality,
+//      |det A| <= prod_i ||row_i||_2,
+//   2. picks just enough 62-bit primes for their product to exceed twice
+//      that bound (each prime is > 2^61, so this is known up front and the
+//      loop stops as soon as the bound is reached),
+//   3. runs Gaussian elimination modulo each prime with machine words
+//      (Montgomery multiplication, no big numbers at all),
+//   4. rebuilds the exact integer with a product-tree Chinese remaindering:
+//      residues are merged pairwise up a balanced tree with mpz_mul and
+//      mpz_invert.  The tree depends only on the primes, so it is built once
+//      per thread and prime count, and reused for every component of a
+//      solution vector.
+//
+// Linear solves follow the same scheme: modulo each prime, y = det(A) * x is
+// computed, and by Cramer's rule y is an integer vector bounded by the same
+// Hadamard product with b appended to each row.  Primes that divide det(A)
+// are skipped.
+
+#ifndef MINIMPZMODULAR_HPP
+#define MINIMPZMODULAR_HPP
+
+#include "mini-gmp.h"
+#include "mini-gmp-plus-config.hpp"
+#include "MiniMPZ.hpp"
+#include "MiniMPZMatrix.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if !MINI_GMP_PLUS_HAS_UINT128 && defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace mini_gmp_plus_modular {
+
+namespace detail {
+
+// 64x64 -> 128-bit product, returns the low word and stores the high word.
+inline uint64_t mul_64x64(uint64_t a, uint64_t b, uint64_t* hi) {
+#if MINI_GMP_PLUS_HAS_UINT128
+    const MINI_GMP_PLUS_UINT128_T p = static_cast<MINI_GMP_PLUS_UINT128_T>(a) * b;
+    *hi = static_cast<uint64_t>(p >> 64);
+    return static_cast<uint64_t>(p);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return _umul128(a, b, hi);
+#else
+    const uint64_t a0 = a & 0xffffffffULL, a1 = a >> 32;
+    const uint64_t b0 = b & 0xffffffffULL, b1 = b >> 32;
+    const uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    const uint64_t mid = (p00 >> 32) + (p01 & 0xffffffffULL) + (p10 & 0xffffffffULL);
+    *hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+    return (mid << 32) | (p00 & 0xffffffffULL);
+#endif
+}
+
+// Arithmetic modulo an odd prime p < 2^62 in Montgomery form (R = 2^64).
+class Montgomery {
+private:
+    uint64_t p_;
+    uint64_t pinv_neg_;   // -p^{-1} mod 2^64
+    uint64_t r2_;         // R^2 mod p
+    uint64_t one_;        // R mod p
+
+    uint64_t redc(uint64_t hi, uint64_t lo) const {
+        const uint64_t m = lo * pinv_neg_;
+        uint64_t thi;
+        const uint64_t tlo = mul_64x64(m, p_, &thi);
+        const uint64_t carry = (lo + tlo) < lo;
+        uint64_t u = hi + thi + carry;
+        return u >= p_ ? u - p_ : u;
+    }
+
+public:
+    explicit
+    Montgomery(uint64_t p) : p_(p) {
+        uint64_t inv = p;
+        for (int i = 0; i < 5; ++i) {
+            inv *= 2 - p * inv;
+        }
+        pinv_neg_ = 0 - inv;
+        one_ = (0 - p) % p;
+        r2_ = one_;
+        for (int i = 0; i < 64; ++i) {
+            r2_ = add(r2_, r2_);
+        }
+    }
+
+    uint64_t modulus() const { return p_; }
+    uint64_t one() const { return one_; }
+
+    uint64_t add(uint64_t a, uint64_t b) const {
+        const uint64_t s = a + b;
+        return s >= p_ ? s - p_ : s;
+    }
+
+    uint64_t sub(uint64_t a, uint64_t b) const {
+        return a >= b ? a - b : a + p_ - b;
+    }
+
+    uint64_t mul(uint64_t a, uint64_t b) const {
+        uint64_t hi;
+        const uint64_t lo = mul_64x64(a, b, &hi);
+        return redc(hi, lo);
+    }
+
+    uint64_t to_mont(uint64_t a) const { return mul(a, r2_); }
+    uint64_t from_mont(uint64_t a) const { return redc(0, a); }
+
+    uint64_t pow(uint64_t a, uint64_t e) const {
+        uint64_t r = one_;
+        while (e != 0) {
+            if ((e & 1U) != 0U) {
+                r = mul(r, a);
+            }
+            a = mul(a, a);
+            e >>= 1;
+        }
+        return r;
+    }
+
+    // Montgomery form of a^{-1}, for a != 0 in Montgomery form.
+    uint64_t inverse(uint64_t a) const { return pow(a, p_ - 2); }
+
+    // Montgomery form of x mod p, by Horner's rule over the limbs of x:
+    // mul(r, R^2) multiplies r by R = 2^64 while staying in Montgomery form.
+    uint64_t reduce(mpz_srcptr x) const {
+        const mp_size_t n = x->_mp_size < 0 ? -x->_mp_size : x->_mp_size;
+        uint64_t r = 0;
+        for (mp_size_t i = n; i-- > 0;) {
+            r = add(mul(r, r2_), to_mont(x->_mp_d[i] % p_));
+        }
+        return x->_mp_size < 0 ? sub(0, r) : r;
+    }
+};
+
+inline bool is_prime_u64(uint64_t n) {
+    static const uint64_t small[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 };
+    for (uint64_t q : small) {
+        if (n % q == 0) {
+            return n == q;
+        }
+    }
+    // Deterministic Miller-Rabin for n < 2^64 with the first 12 prime bases.
+    const Montgomery mont(n);
+    uint64_t d = n - 1;
+    int s = 0;
+    while ((d & 1U) == 0U) {
+        d >>= 1;
+        ++s;
+    }
+    const uint64_t minus_one = mont.sub(0, mont.one());
+    for (uint64_t q : small) {
+        uint64_t x = mont.pow(mont.to_mont(q), d);
+        if (x == mont.one() || x == minus_one) {
+            continue;
+        }
+        bool composite = true;
+        for (int i = 1; i < s && composite; ++i) {
+            x = mont.mul(x, x);
+            composite = (x != minus_one);
+        }
+        if (composite) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The first `count` primes below 2^62, in decreasing order (all > 2^61).
+// Cached per thread since the same primes serve every matrix.
+inline const std::vector<uint64_t>& primes(std::size_t count) {
+    thread_local std::vector<uint64_t> cache;
+    uint64_t candidate = cache.empty() ? (uint64_t(1) << 62) - 1 : cache.back() - 2;
+    while (cache.size() < count) {
+        if (is_prime_u64(candidate)) {
+            cache.push_back(candidate);
+        }
+        candidate -= 2;
+    }
+    return cache;
+}
+
+// Number of bits of ceil(sqrt(s)) upper bound: sqrt(s) < 2^ceil(bits(s)/2).
+inline std::size_t sqrt_bound_bits(const MiniMPZ& s) {
+    if (s.sign() == 0) {
+        return 0;
+    }
+    return (mpz_sizeinbase(s.get_mpz(), 2) + 1) / 2;
+}
+
+inline void set_u64(MiniMPZ& z, uint64_t v) {
+    if (v == 0) {
+        mpz_set_ui(z.get_mpz(), 0);
+        return;
+    }
+    mp_ptr p = mpz_limbs_write(z.get_mpz(), 1);
+    p[0] = v;
+    mpz_limbs_finish(z.get_mpz(), 1);
+}
+
+// Gaussian elimination of the n x (n + extra) matrix `a` (Montgomery form,
+// row-major) modulo p. Returns det(A) in Montgomery form (0 if singular).
+// If extra == 1 and A is non-singular, the last column is replaced by the
+// solution x of A x = b (in Montgomery form) in a[k * (n + 1) + n].
+inline uint64_t eliminate(const Montgomery& mont, std::vector<uint64_t>& a, std::size_t n, std::size_t extra) {
+    const std::size_t m = n + extra;
+    uint64_t det = mont.one();
+    std::vector<uint64_t> pivot_inv(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        std::size_t p = k;
+        while (p < n && a[p * m + k] == 0) {
+            ++p;
+        }
+        if (p == n) {
+            return 0;
+        }
+        if (p != k) {
+            for (std::size_t j = k; j < m; ++j) {
+                std::swap(a[p * m + j], a[k * m + j]);
+            }
+            det = mont.sub(0, det);
+        }
+        det = mont.mul(det, a[k * m + k]);
+        pivot_inv[k] = mont.inverse(a[k * m + k]);
+        for (std::size_t i = k + 1; i < n; ++i) {
+            const uint64_t f = mont.mul(a[i * m + k], pivot_inv[k]);
+            if (f == 0) {
+                continue;
+            }
+            for (std::size_t j = k + 1; j < m; ++j) {
+                a[i * m + j] = mont.sub(a[i * m + j], mont.mul(f, a[k * m + j]));
+            }
+        }
+    }
+    if (extra == 1) {
+        for (std::size_t k = n; k-- > 0;) {
+            uint64_t c = a[k * m + n];
+            for (std::size_t j = k + 1; j < n; ++j) {
+                c = mont.sub(c, mont.mul(a[k * m + j], a[j * m + n]));
+            }
+            a[k * m + n] = mont.mul(c, pivot_inv[k]);
+        }
+    }
+    return det;
+}
+
+} // namespace detail
+
+// Product-tree Chinese remaindering over a fixed set of pairwise coprime
+// word-size moduli. Building the tree computes the subproducts and, at each
+// internal node, the inverse of the left product modulo the right product;
+// reconstruct() then only needs mpz_mul / mpz_mod per node.
+class CrtBasis {
+private:
+    struct Node {
+        std::size_t left;
+        std::size_t right;
+        MiniMPZ modulus;
+        MiniMPZ left_inv;   // (left modulus)^{-1} mod (right modulus)
+    };
+
+    std::vector<Node> nodes_;
+    std::size_t count_{};
+    std::size_t root_{};
+    MiniMPZ half_;
+
+    std::size_t build(const uint64_t* moduli, std::size_t n) {
+        Node node;
+        if (n == 1) {
+            node.left = node.right = 0;
+            detail::set_u64(node.modulus, moduli[0]);
+        } else {
+            node.left = build(moduli, n / 2);
+            node.right = build(moduli + n / 2, n - n / 2);
+            const MiniMPZ& ml = nodes_[node.left].modulus;
+            const MiniMPZ& mr = nodes_[node.right].modulus;
+            mpz_mul(node.modulus.get_mpz(), ml.get_mpz(), mr.get_mpz());
+            if (mpz_invert(node.left_inv.get_mpz(), ml.get_mpz(), mr.get_mpz()) == 0) {
+                throw std::invalid_argument("CrtBasis: moduli are not pairwise coprime");
+            }
+        }
+        nodes_.push_back(std::move(node));
+        return nodes_.size() - 1;
+    }
+
+    void combine(std::size_t idx, const uint64_t* residues, std::size_t n, MiniMPZ& x) const {
+        const Node& node = nodes_[idx];
+        if (n == 1) {
+            detail::set_u64(x, residues[0]);
+            return;
+        }
+        MiniMPZ xr;
+        combine(node.left, residues, n / 2, x);
+        combine(node.right, residues + n / 2, n - n / 2, xr);
+        // x = xl + ml * ((xr - xl) * ml^{-1} mod mr)
+        mpz_sub(xr.get_mpz(), xr.get_mpz(), x.get_mpz());
+        mpz_mul(xr.get_mpz(), xr.get_mpz(), node.left_inv.get_mpz());
+        mpz_mod(xr.get_mpz(), xr.get_mpz(), nodes_[node.right].modulus.get_mpz());
+        mpz_addmul(x.get_mpz(), xr.get_mpz(), nodes_[node.left].modulus.get_mpz());
+    }
+
+public:
+    explicit
+    CrtBasis(const std::vector<uint64_t>& moduli) : count_(moduli.size()) {
+        if (moduli.empty()) {
+            throw std::invalid_argument("CrtBasis: empty set of moduli");
+        }
+        nodes_.reserve(2 * moduli.size());
+        root_ = build(moduli.data(), moduli.size());
+        mpz_tdiv_q_2exp(half_.get_mpz(), modulus().get_mpz(), 1);
+    }
+
+    std::size_t size() const { return count_; }
+    const MiniMPZ& modulus() const { return nodes_[root_].modulus; }
+
+    // The unique x in (-M/2, M/2] with x = residues[i] mod moduli[i].
+    MiniMPZ reconstruct(const std::vector<uint64_t>& residues) const {
+        if (residues.size() != count_) {
+            throw std::invalid_argument("CrtBasis: residue count does not match the basis");
+        }
+        MiniMPZ x;
+        combine(root_, residues.data(), count_, x);
+        if (mpz_cmp(x.get_mpz(), half_.get_mpz()) > 0) {
+            mpz_sub(x.get_mpz(), x.get_mpz(), modulus().get_mpz());
+        }
+        return x;
+    }
+};
+
+namespace detail {
+
+// CrtBasis over the first `count` primes of primes(), cached per thread:
+// the subproducts and tree inverses then cost nothing after the first call.
+inline const CrtBasis& prime_basis(std::size_t count) {
+    thread_local std::vector<std::unique_ptr<CrtBasis>> cache;
+    if (cache.size() <= count) {
+        cache.resize(count + 1);
+    }
+    if (!cache[count]) {
+        const std::vector<uint64_t>& p = primes(count);
+        cache[count].reset(new CrtBasis(std::vector<uint64_t>(p.begin(), p.begin() + count)));
+    }
+    return *cache[count];
+}
+
+// Number of 62-bit primes (each > 2^61) whose product exceeds 2^(bound_bits+1).
+inline std::size_t primes_for_bound(std::size_t bound_bits) {
+    return (bound_bits + 1) / 61 + 1;
+}
+
+// Hadamard bound (in bits) of the determinants of A and, if b is given, of
+// every matrix obtained by replacing one column of A by b.
+inline std::size_t hadamard_bits(const MiniMPZMatrix& a, const std::vector<MiniMPZ>* b) {
+    std::size_t bits = 0;
+    MiniMPZ s;
+    for (std::size_t i = 0; i < a.rows(); ++i) {
+        mpz_set_ui(s.get_mpz(), 0);
+        for (std::size_t j = 0; j < a.cols(); ++j) {
+            mpz_addmul(s.get_mpz(), a(i, j).get_mpz(), a(i, j).get_mpz());
+        }
+        if (b != nullptr) {
+            mpz_addmul(s.get_mpz(), (*b)[i].get_mpz(), (*b)[i].get_mpz());
+        }
+        bits += sqrt_bound_bits(s);
+    }
+    return bits;
+}
+
+inline void load(const Montgomery& mont, const MiniMPZMatrix& a, const std::vector<MiniMPZ>* b,
+                 std::vector<uint64_t>& out) {
+    const std::size_t n = a.rows();
+    const std::size_t m = n + (b != nullptr ? 1 : 0);
+    out.resize(n * m);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            out[i * m + j] = mont.reduce(a(i, j).get_mpz());
+        }
+        if (b != nullptr) {
+            out[i * m + n] = mont.reduce((*b)[i].get_mpz());
+        }
+    }
+}
+
+} // namespace detail
+
+// Exact determinant of a square matrix via determinants modulo 62-bit primes.
+inline MiniMPZ determinant(const MiniMPZMatrix& a) {
+    if (a.rows() != a.cols()) {
+        throw std::invalid_argument("mini_gmp_plus_modular::determinant requires a square matrix");
+    }
+    const std::size_t n = a.rows();
+    if (n == 0) {
+        return MiniMPZ(1L);
+    }
+    const std::size_t count = detail::primes_for_bound(detail::hadamard_bits(a, nullptr));
+    const std::vector<uint64_t>& primes = detail::primes(count);
+
+    std::vector<uint64_t> residues(count);
+    std::vector<uint64_t> work;
+    for (std::size_t k = 0; k < count; ++k) {
+        const detail::Montgomery mont(primes[k]);
+        detail::load(mont, a, nullptr, work);
+        residues[k] = mont.from_mont(detail::eliminate(mont, work, n, 0));
+    }
+    return detail::prime_basis(count).reconstruct(residues);
+}
+
+// Solve A x = b for square non-singular A, with the same conventions as
+// MiniMPZMatrix::solve: x[i] / denominator is the solution, denominator =
+// |det(A)|. Returns false if A is singular.
+inline bool solve(const MiniMPZMatrix& a, const std::vector<MiniMPZ>& b,
+                  std::vector<MiniMPZ>& x, MiniMPZ& denominator) {
+    if (a.rows() != a.cols() || b.size() != a.rows()) {
+        throw std::invalid_argument("mini_gmp_plus_modular::solve requires a square matrix and a matching right-hand side");
+    }
+    const std::size_t n = a.rows();
+    if (n == 0) {
+        x.clear();
+        denominator = MiniMPZ(1L);
+        return true;
+    }
+    const std::size_t count = detail::primes_for_bound(detail::hadamard_bits(a, &b));
+
+    // Residues per prime: det(A) and y = det(A) * x, for primes not dividing
+    // det(A). If more than `count` primes divide det(A), their product
+    // exceeds the Hadamard bound, so det(A) = 0.
+    std::vector<uint64_t> used;
+    std::vector<uint64_t> det_residues;
+    std::vector<std::vector<uint64_t>> y_residues(n);
+    std::vector<uint64_t> work;
+    std::size_t unlucky = 0;
+    for (std::size_t k = 0; used.size() < count; ++k) {
+        const uint64_t p = detail::primes(k + 1)[k];
+        const detail::Montgomery mont(p);
+        detail::load(mont, a, &b, work);
+        const uint64_t det = detail::eliminate(mont, work, n, 1);
+        if (det == 0) {
+            if (++unlucky >= count) {
+                return false;
+            }
+            continue;
+        }
+        used.push_back(p);
+        det_residues.push_back(mont.from_mont(det));
+        for (std::size_t i = 0; i < n; ++i) {
+            y_residues[i].push_back(mont.from_mont(mont.mul(det, work[i * (n + 1) + n])));
+        }
+    }
+
+    // Without unlucky primes, `used` is the cached prefix of primes().
+    std::unique_ptr<CrtBasis> own_basis;
+    if (unlucky != 0) {
+        own_basis.reset(new CrtBasis(used));
+    }
+    const CrtBasis& basis = own_basis ? *own_basis : detail::prime_basis(count);
+    MiniMPZ d = basis.reconstruct(det_residues);
+    std::vector<MiniMPZ> y(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        y[i] = basis.reconstruct(y_residues[i]);
+        if (d.sign() < 0) {
+            mpz_neg(y[i].get_mpz(), y[i].get_mpz());
+        }
+    }
+    mpz_abs(d.get_mpz(), d.get_mpz());
+    denominator = std::move(d);
+    x.swap(y);
+    return true;
+}
+
+} // namespace mini_gmp_plus_modular
+
+#endif // MINIMPZMODULAR_HPP
@@ -0,0 +1,179 @@
+// MiniMPZVector.hpp
+//
+// MiniMPZVector: a sequence of integers whose limbs share one contiguous slab.
+//
+// std::vector<MiniMPZ> keeps every value larger than the local buffer in its
+// own heap block, so a pass over the elements jumps around memory.  Here all
+// limbs live back to back in a single growable array, and the per-element
+// headers are kept in separate arrays (structure of arrays):
+//   offset   - index of the first limb in the slab
+//   size     - signed limb count, same convention as _mp_size
+//   capacity - limbs reserved for the element, so updates can stay in place
+//
+// Elements are exposed as read-only mpz_t views built with mpz_roinit_n(),
+// which can be passed directly to any mpz_ function taking a const mpz_t.
+// A view is invalidated by any operation that may grow the slab (push_back,
+// set with a larger value, reserve, compact).
+
+#ifndef MINIMPZVECTOR_HPP
+#define MINIMPZVECTOR_HPP
+
+#include "mini-gmp.h"
+#include "MiniMPZ.hpp"
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+class MiniMPZVector {
+private:
+    std::vector<mp_limb_t> limbs_;
+    std::vector<std::size_t> offsets_;
+    std::vector<int> sizes_;
+    std::vector<int> capacities_;
+    std::size_t wasted_limbs_{};
+
+    static int abs_size(int s) { return s < 0 ? -s : s; }
+
+    void check_index(std::size_t i) const {
+        if (i >= sizes_.size()) {
+            throw std::out_of_range("MiniMPZVector index out of range");
+        }
+    }
+
+    bool in_slab(mp_srcptr p) const {
+        return !limbs_.empty() && p >= limbs_.data() && p < limbs_.data() + limbs_.size();
+    }
+
+    // Append n limbs of storage at the end of the slab, returns their offset.
+    std::size_t allocate(std::size_t n) {
+        const std::size_t offset = limbs_.size();
+        limbs_.resize(offset + n);
+        return offset;
+    }
+
+public:
+    MiniMPZVector() = default;
+
+    explicit
+    MiniMPZVector(std::size_t count) : offsets_(count, 0), sizes_(count, 0), capacities_(count, 0) {}
+
+    // Capacity
+    std::size_t size() const { return sizes_.size(); }
+    bool empty() const { return sizes_.empty(); }
+    std::size_t limb_count() const { return limbs_.size(); }
+    std::size_t wasted_limbs() const { return wasted_limbs_; }
+
+    void reserve(std::size_t count, std::size_t limbs) {
+        offsets_.reserve(count);
+        sizes_.reserve(count);
+        capacities_.reserve(count);
+        limbs_.reserve(limbs);
+    }
+
+    void clear() {
+        limbs_.clear();
+        offsets_.clear();
+        sizes_.clear();
+        capacities_.clear();
+        wasted_limbs_ = 0;
+    }
+
+    // Append a copy of val, reserving at least min_capacity limbs for it.
+    void push_back(mpz_srcptr val, int min_capacity = 0) {
+        // val may be a view into this slab: copy it before the slab grows
+        if (in_slab(val->_mp_d)) {
+            MiniMPZ tmp;
+            mpz_set(tmp.get_mpz(), val);
+            push_back(tmp.get_mpz(), min_capacity);
+            return;
+        }
+        const int n = abs_size(val->_mp_size);
+        const int capacity = n > min_capacity ? n : min_capacity;
+        const std::size_t offset = allocate(static_cast<std::size_t>(capacity));
+        if (n > 0) {
+            std::memcpy(&limbs_[offset], val->_mp_d, static_cast<std::size_t>(n) * sizeof(mp_limb_t));
+        }
+        offsets_.push_back(offset);
+        sizes_.push_back(val->_mp_size);
+        capacities_.push_back(capacity);
+    }
+
+    void push_back(const MiniMPZ& val, int min_capacity = 0) {
+        push_back(val.get_mpz(), min_capacity);
+    }
+
+    // Overwrite element i. Stays in place when the value fits the element's
+    // capacity, otherwise the element moves to the end of the slab and its
+    // old limbs are counted in wasted_limbs() until compact() is called.
+    void set(std::size_t i, mpz_srcptr val) {
+        check_index(i);
+        const int n = abs_size(val->_mp_size);
+        if (n > capacities_[i]) {
+            if (in_slab(val->_mp_d)) {
+                MiniMPZ tmp;
+                mpz_set(tmp.get_mpz(), val);
+                set(i, tmp.get_mpz());
+                return;
+            }
+            wasted_limbs_ += static_cast<std::size_t>(capacities_[i]);
+            offsets_[i] = allocate(static_cast<std::size_t>(n));
+            capacities_[i] = n;
+        }
+        if (n > 0) {
+            std::memmove(&limbs_[offsets_[i]], val->_mp_d, static_cast<std::size_t>(n) * sizeof(mp_limb_t));
+        }
+        sizes_[i] = val->_mp_size;
+    }
+
+    void set(std::size_t i, const MiniMPZ& val) {
+        set(i, val.get_mpz());
+    }
+
+    // Read-only view of element i; `holder` provides the mpz_t header.
+    // Zero elements point at a static limb, since some mpz_ macros
+    // (mpz_odd_p) read _mp_d[0] regardless of the size.
+    mpz_srcptr view(std::size_t i, mpz_t holder) const {
+        static const mp_limb_t zero_limb = 0;
+        if (sizes_[i] == 0) {
+            return mpz_roinit_n(holder, &zero_limb, 0);
+        }
+        return mpz_roinit_n(holder, limbs_.data() + offsets_[i], sizes_[i]);
+    }
+
+    MiniMPZ get(std::size_t i) const {
+        check_index(i);
+        MiniMPZ result;
+        mpz_t v;
+        mpz_set(result.get_mpz(), view(i, v));
+        return result;
+    }
+
+    // Raw header access for mpn_ level scans.
+    mp_srcptr limbs(std::size_t i) const { return limbs_.data() + offsets_[i]; }
+    mp_size_t limb_size(std::size_t i) const { return abs_size(sizes_[i]); }
+    int sign(std::size_t i) const { return (sizes_[i] > 0) - (sizes_[i] < 0); }
+
+    // Repack the elements in index order, dropping the limbs left behind by
+    // set() and trimming each capacity to the current size.
+    void compact() {
+        std::vector<mp_limb_t> packed;
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < sizes_.size(); ++i) {
+            total += static_cast<std::size_t>(abs_size(sizes_[i]));
+        }
+        packed.reserve(total);
+        for (std::size_t i = 0; i < sizes_.size(); ++i) {
+            const std::size_t n = static_cast<std::size_t>(abs_size(sizes_[i]));
+            const std::size_t offset = packed.size();
+            packed.insert(packed.end(), limbs_.begin() + static_cast<std::ptrdiff_t>(offsets_[i]),
+                          limbs_.begin() + static_cast<std::ptrdiff_t>(offsets_[i] + n));
+            offsets_[i] = offset;
+            capacities_[i] = static_cast<int>(n);
+        }
+        limbs_.swap(packed);
+        wasted_limbs_ = 0;
+    }
+};
+
+#endif // MINIMPZVECTOR_HPP
@@ -0,0 +1,391 @@
+// SmallMPZ.hpp
+//
+// SmallMPZ<K>: arbitrary-precision integer with a per-type inline limb
+// buffer of K limbs.
+//
+// MINI_GMP_PLUS_BUFF_SIZE fixes the inline capacity of every mpz_t in the
+// program (5 limbs, 56 bytes per mpz_t).  SmallMPZ lets each kernel pick its
+// own trade-off: SmallMPZ<1> is 24 bytes for coordinates that fit in a word,
+// SmallMPZ<8> keeps 6-8 limb intermediates off the heap.  Values that outgrow
+// K limbs spill to memory obtained through mp_get_memory_functions(), like
+// any other mini-gmp-plus allocation.
+//
+// Addition, subtraction and multiplication run directly on the inline limbs
+// with the mpn_ kernels.  Everything else goes through the C API:
+//   - read:  view() wraps the limbs in a read-only mpz_t with mpz_roinit_n()
+//   - write: set(mpz_srcptr), or limbs_write() / limbs_finish() for mpn_
+//            kernels, mirroring mpz_limbs_write() / mpz_limbs_finish().
+
+#ifndef SMALLMPZ_HPP
+#define SMALLMPZ_HPP
+
+#include "mini-gmp.h"
+#include "MiniMPZ.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <ostream>
+#include <utility>
+
+template<int K>
+class SmallMPZ {
+    static_assert(K >= 1, "SmallMPZ needs at least one inline limb");
+
+private:
+    mp_limb_t* d_;      // buff_ while the value fits inline, heap otherwise
+    int alloc_;         // capacity of d_ in limbs
+    int size_;          // signed limb count, same convention as _mp_size
+    mp_limb_t buff_[K];
+
+    template<int> friend class SmallMPZ;
+
+    bool is_inline() const { return d_ == buff_; }
+
+    static int abs_size(int s) { return s < 0 ? -s : s; }
+
+    static mp_size_t normalized_size(mp_srcptr xp, mp_size_t n) {
+        while (n > 0 && xp[n - 1] == 0) {
+            --n;
+        }
+        return n;
+    }
+
+    static int cmp4(mp_srcptr ap, mp_size_t an, mp_srcptr bp, mp_size_t bn) {
+        if (an != bn) {
+            return an < bn ? -1 : 1;
+        }
+        return mpn_cmp(ap, bp, an);
+    }
+
+    void release() {
+        if (!is_inline()) {
+            void (*free_func)(void*, size_t);
+            mp_get_memory_functions(nullptr, nullptr, &free_func);
+            free_func(d_, static_cast<size_t>(alloc_) * sizeof(mp_limb_t));
+        }
+    }
+
+    // Grow storage to at least n limbs, preserving the current value.
+    mp_ptr reserve(mp_size_t n) {
+        if (n <= alloc_) {
+            return d_;
+        }
+        void* (*alloc_func)(size_t);
+        mp_get_memory_functions(&alloc_func, nullptr, nullptr);
+        mp_ptr p = static_cast<mp_ptr>(alloc_func(static_cast<size_t>(n) * sizeof(mp_limb_t)));
+        const int n_used = abs_size(size_);
+        if (n_used > 0) {
+            std::memcpy(p, d_, static_cast<size_t>(n_used) * sizeof(mp_limb_t));
+        }
+        release();
+        d_ = p;
+        alloc_ = static_cast<int>(n);
+        return d_;
+    }
+
+    void steal(SmallMPZ& other) noexcept {
+        alloc_ = other.alloc_;
+        size_ = other.size_;
+        if (other.is_inline()) {
+            d_ = buff_;
+            std::memcpy(buff_, other.buff_, static_cast<size_t>(abs_size(size_)) * sizeof(mp_limb_t));
+        } else {
+            d_ = other.d_;
+            other.d_ = other.buff_;
+            other.alloc_ = K;
+        }
+        other.size_ = 0;
+    }
+
+    // |r| = |a| + |b|, returns the limb count of the result.
+    static int abs_add(SmallMPZ& r, const SmallMPZ& a, const SmallMPZ& b) {
+        const SmallMPZ* x = &a;
+        const SmallMPZ* y = &b;
+        if (abs_size(x->size_) < abs_size(y->size_)) {
+            std::swap(x, y);
+        }
+        const mp_size_t xn = abs_size(x->size_);
+        const mp_size_t yn = abs_size(y->size_);
+        if (xn == 0) {
+            return 0;
+        }
+        mp_ptr rp = r.reserve(xn + 1);
+        const mp_limb_t cy = mpn_add(rp, x->d_, xn, y->d_, yn);
+        rp[xn] = cy;
+        return static_cast<int>(xn + (cy != 0));
+    }
+
+    // |r| = ||a| - |b||, returns the limb count, negated if |a| < |b|.
+    static int abs_sub(SmallMPZ& r, const SmallMPZ& a, const SmallMPZ& b) {
+        const mp_size_t an = abs_size(a.size_);
+        const mp_size_t bn = abs_size(b.size_);
+        const int cmp = cmp4(a.d_, an, b.d_, bn);
+        if (cmp > 0) {
+            mp_ptr rp = r.reserve(an);
+            mpn_sub(rp, a.d_, an, b.d_, bn);
+            return static_cast<int>(normalized_size(rp, an));
+        }
+        if (cmp < 0) {
+            mp_ptr rp = r.reserve(bn);
+            mpn_sub(rp, b.d_, bn, a.d_, an);
+            return -static_cast<int>(normalized_size(rp, bn));
+        }
+        return 0;
+    }
+
+public:
+    static constexpr int inline_limbs = K;
+
+    // Constructors
+    SmallMPZ() : d_(buff_), alloc_(K), size_(0) {}
+
+    explicit
+    SmallMPZ(long val) : SmallMPZ() { set_si(val); }
+
+    explicit
+    SmallMPZ(mpz_srcptr val) : SmallMPZ() { set(val); }
+
+    explicit
+    SmallMPZ(const MiniMPZ& val) : SmallMPZ() { set(val.get_mpz()); }
+
+    // Copy constructor
+    SmallMPZ(const SmallMPZ& other) : SmallMPZ() {
+        const int n = abs_size(other.size_);
+        mp_ptr rp = reserve(n);
+        if (n > 0) {
+            std::memcpy(rp, other.d_, static_cast<size_t>(n) * sizeof(mp_limb_t));
+        }
+        size_ = other.size_;
+    }
+
+    // Move constructor: takes over heap limbs, copies inline ones
+    SmallMPZ(SmallMPZ&& other) noexcept { steal(other); }
+
+    // Destructor
+    ~SmallMPZ() { release(); }
+
+    // Copy assignment
+    SmallMPZ& operator=(const SmallMPZ& other) {
+        if (this != &other) {
+            const int n = abs_size(other.size_);
+            size_ = 0;
+            mp_ptr rp = reserve(n);
+            if (n > 0) {
+                std::memcpy(rp, other.d_, static_cast<size_t>(n) * sizeof(mp_limb_t));
+            }
+            size_ = other.size_;
+        }
+        return *this;
+    }
+
+    // Move assignment
+    SmallMPZ& operator=(SmallMPZ&& other) noexcept {
+        if (this != &other) {
+            release();
+            steal(other);
+        }
+        return *this;
+    }
+
+    void swap(SmallMPZ& other) noexcept {
+        SmallMPZ tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    // Assignment from native and C types
+    void set_si(long val) {
+        if (val == 0) {
+            size_ = 0;
+            return;
+        }
+        const mp_limb_t mag = val < 0 ? static_cast<mp_limb_t>(0) - static_cast<mp_limb_t>(val)
+                                      : static_cast<mp_limb_t>(val);
+        d_[0] = mag;
+        size_ = val < 0 ? -1 : 1;
+    }
+
+    void set(mpz_srcptr val) {
+        const int n = abs_size(val->_mp_size);
+        size_ = 0;
+        mp_ptr rp = reserve(n);
+        if (n > 0) {
+            std::memmove(rp, val->_mp_d, static_cast<size_t>(n) * sizeof(mp_limb_t));
+        }
+        size_ = val->_mp_size;
+    }
+
+    template<int J>
+    void set(const SmallMPZ<J>& val) {
+        mpz_t v;
+        set(val.view(v));
+    }
+
+    // Read-only mpz_t view of the limbs, valid until this object is modified.
+    // `holder` provides the storage for the mpz_t header.
+    mpz_srcptr view(mpz_t holder) const {
+        return mpz_roinit_n(holder, d_, size_);
+    }
+
+    // Direct limb access, mirroring mpz_limbs_read / _write / _finish.
+    mp_srcptr limbs_read() const { return d_; }
+
+    mp_ptr limbs_write(mp_size_t n) {
+        size_ = 0;
+        return reserve(n);
+    }
+
+    void limbs_finish(mp_size_t xs) {
+        const mp_size_t xn = normalized_size(d_, xs < 0 ? -xs : xs);
+        size_ = static_cast<int>(xs < 0 ? -xn : xn);
+    }
+
+    mp_size_t size() const { return abs_size(size_); }
+    int capacity() const { return alloc_; }
+    bool is_small() const { return is_inline(); }
+
+    // r = a + b, r = a - b, r = a * b (r may alias a and/or b)
+    friend void add(SmallMPZ& r, const SmallMPZ& a, const SmallMPZ& b) {
+        int rn;
+        if ((a.size_ ^ b.size_) >= 0) {
+            rn = abs_add(r, a, b);
+        } else {
+            rn = abs_sub(r, a, b);
+        }
+        r.size_ = a.size_ >= 0 ? rn : -rn;
+    }
+
+    friend void sub(SmallMPZ& r, const SmallMPZ& a, const SmallMPZ& b) {
+        int rn;
+        if ((a.size_ ^ b.size_) >= 0) {
+            rn = abs_sub(r, a, b);
+        } else {
+            rn = abs_add(r, a, b);
+        }
+        r.size_ = a.size_ >= 0 ? rn : -rn;
+    }
+
+    friend void mul(SmallMPZ& r, const SmallMPZ& a, const SmallMPZ& b) {
+        if (&r == &a || &r == &b) {
+            SmallMPZ t;
+            mul(t, a, b);
+            r = std::move(t);
+            return;
+        }
+        mp_size_t an = abs_size(a.size_);
+        mp_size_t bn = abs_size(b.size_);
+        if (an == 0 || bn == 0) {
+            r.size_ = 0;
+            return;
+        }
+        const int negative = (a.size_ ^ b.size_) < 0;
+        mp_srcptr ap = a.d_;
+        mp_srcptr bp = b.d_;
+        if (an < bn) {
+            std::swap(ap, bp);
+            std::swap(an, bn);
+        }
+        r.size_ = 0;
+        mp_ptr rp = r.reserve(an + bn);
+        mpn_mul(rp, ap, an, bp, bn);
+        const int rn = static_cast<int>(an + bn - (rp[an + bn - 1] == 0));
+        r.size_ = negative ? -rn : rn;
+    }
+
+    // Arithmetic operators
+    SmallMPZ operator+(const SmallMPZ& other) const {
+        SmallMPZ result;
+        add(result, *this, other);
+        return result;
+    }
+
+    SmallMPZ operator-(const SmallMPZ& other) const {
+        SmallMPZ result;
+        sub(result, *this, other);
+        return result;
+    }
+
+    SmallMPZ operator*(const SmallMPZ& other) const {
+        SmallMPZ result;
+        mul(result, *this, other);
+        return result;
+    }
+
+    SmallMPZ operator-() const {
+        SmallMPZ result(*this);
+        result.size_ = -result.size_;
+        return result;
+    }
+
+    // Compound assignment operators
+    SmallMPZ& operator+=(const SmallMPZ& other) {
+        add(*this, *this, other);
+        return *this;
+    }
+
+    SmallMPZ& operator-=(const SmallMPZ& other) {
+        sub(*this, *this, other);
+        return *this;
+    }
+
+    SmallMPZ& operator*=(const SmallMPZ& other) {
+        mul(*this, *this, other);
+        return *this;
+    }
+
+    // Comparison
+    int compare(const SmallMPZ& other) const {
+        if (size_ != other.size_) {
+            return size_ < other.size_ ? -1 : 1;
+        }
+        const int cmp = mpn_cmp(d_, other.d_, abs_size(size_));
+        return size_ >= 0 ? cmp : -cmp;
+    }
+
+    bool operator==(const SmallMPZ& other) const { return compare(other) == 0; }
+    bool operator!=(const SmallMPZ& other) const { return compare(other) != 0; }
+    bool operator<(const SmallMPZ& other) const { return compare(other) < 0; }
+    bool operator<=(const SmallMPZ& other) const { return compare(other) <= 0; }
+    bool operator>(const SmallMPZ& other) const { return compare(other) > 0; }
+    bool operator>=(const SmallMPZ& other) const { return compare(other) >= 0; }
+
+    int sign() const { return (size_ > 0) - (size_ < 0); }
+
+    // Conversion methods
+    MiniMPZ to_mpz() const {
+        MiniMPZ result;
+        mpz_t v;
+        mpz_set(result.get_mpz(), view(v));
+        return result;
+    }
+
+    long to_long() const {
+        mpz_t v;
+        return mpz_get_si(view(v));
+    }
+
+    double to_double() const {
+        mpz_t v;
+        return mpz_get_d(view(v));
+    }
+
+    std::string to_string(int base = 10) const {
+        mpz_t v;
+        char* str = mpz_get_str(nullptr, base, view(v));
+        std::string result(str);
+        free(str);
+        return result;
+    }
+
+    // Stream output
+    friend std::ostream& operator<<(std::ostream& os, const SmallMPZ& num) {
+        return os << num.to_string();
+    }
+};
+
+template<int K>
+inline void swap(SmallMPZ<K>& a, SmallMPZ<K>& b) noexcept {
+    a.swap(b);
+}
+
+#endif // SMALLMPZ_HPP
@@ -1,12 +1,20 @@
 #include "geometry_workloads.hpp"
+#include "../MiniMPZMatrix.hpp"
+#include "../MiniMPZModular.hpp"
+#include "../MiniMPFPredicates.hpp"
 
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <random>
 #include <stdexcept>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -65,6 +73,82 @@ struct GcdInput {
     MiniMPZ rhs;
 };
 
+struct Det16Input {
+    MiniMPZMatrix matrix;
+};
+
+// Four points in [-1, 1)^3 for orient3d, 12 doubles packed as a, b, c, d.
+struct Orient3dInput {
+    double points[12];
+};
+
+// 64 orient3d quadruples in structure-of-arrays layout for the batched filter.
+struct Orient3dBatchInput {
+    std::vector<double> coords[12];
+    mutable std::vector<int> signs;
+    mutable std::vector<std::size_t> uncertain;
+};
+
+// 32 doubles in [0.5, 1.5) for a MiniMPF multiply-add chain.
+struct MpfChainInput {
+    std::vector<MiniMPF> factors;
+};
+
+// 64 doubles of mixed sign spread over 2^-40 .. 2^40, so that consecutive
+// MiniMPF additions almost always need exponent alignment.
+struct MpfSumInput {
+    std::vector<MiniMPF> terms;
+};
+
+// Two 32-vectors of doubles with mixed signs and exponents.
+struct MpfDotInput {
+    std::array<MiniMPF, 32> lhs;
+    std::array<MiniMPF, 32> rhs;
+};
+
+// Two 16-vectors of doubles over 2^-30 .. 2^30: product exponents stay
+// within the 256-bit fast path of dot_product.
+struct MpfDot16Input {
+    std::array<MiniMPF, 16> lhs;
+    std::array<MiniMPF, 16> rhs;
+};
+
+// One million MiniMPF values (doubles over 2^-40 .. 2^40 and 128-bit
+// mantissas) sorted from a fresh shuffle on every run.
+struct MpfSortInput {
+    mutable std::vector<MiniMPF> values;
+    uint32_t shuffle_seed;
+};
+
+// 64 independent 4-limb operands and multipliers (one per mesh element),
+// both one operand after the other and interleaved for mpn_addmul_1_batch.
+struct AddmulBatchInput {
+    static const mp_size_t count = 64;
+    static const mp_size_t limbs = 4;
+    std::vector<mp_limb_t> operands;
+    std::vector<mp_limb_t> interleaved;
+    std::vector<mp_limb_t> multipliers;
+    mutable std::vector<mp_limb_t> accumulators;
+    mutable std::vector<mp_limb_t> carries;
+};
+
+// 2048-bit operands and an odd 2048-bit modulus (the RSA range of the IFMA
+// kernels), a, b < m.
+struct Mul2048Input {
+    static const mp_size_t limbs = 32;
+    std::array<mp_limb_t, limbs> a;
+    std::array<mp_limb_t, limbs> b;
+    std::array<mp_limb_t, limbs> m;
+    mutable std::array<mp_limb_t, 2 * limbs> r;
+};
+
+// Sorting and vector growth are dominated by MiniMPZ moves and swaps.
+// The values mix local-buffer (128-bit) and heap-backed (448-bit) mantissas.
+struct MoveInput {
+    mutable std::vector<MiniMPZ> values;
+    uint32_t shuffle_seed;
+};
+
 struct BenchmarkResult {
     std::string name;
     std::size_t operations;
@@ -236,6 +320,22 @@ std::vector<Det4Input> make_det4_inputs(std::size_t count, SplitMix64& rng) {
     return inputs;
 }
 
+std::vector<Det16Input> make_det16_inputs(std::size_t count, SplitMix64& rng) {
+    std::vector<Det16Input> inputs;
+    inputs.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        Det16Input input;
+        input.matrix = MiniMPZMatrix(16, 16);
+        for (std::size_t r = 0; r < 16; ++r) {
+            for (std::size_t c = 0; c < 16; ++c) {
+                input.matrix(r, c) = make_random_value(rng, 48U, true);
+            }
+        }
+        inputs.push_back(std::move(input));
+    }
+    return inputs;
+}
+
 std::vector<SqrtInput> make_sqrt_inputs(std::size_t count, SplitMix64& rng) {
     std::vector<SqrtInput> inputs;
     inputs.reserve(count);
@@ -264,6 +364,158 @@ std::vector<GcdInput> make_gcd_inputs(std::size_t count, SplitMix64& rng) {
     return inputs;
 }
 
+std::vector<MoveInput> make_move_inputs(std::size_t count, SplitMix64& rng) {
+    std::vector<MoveInput> inputs;
+    inputs.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        MoveInput input;
+        input.values.reserve(64);
+        for (std::size_t j = 0; j < 64; ++j) {
+            input.values.push_back(make_random_value(rng, (j & 1U) != 0U ? 448U : 128U, true));
+        }
+        input.shuffle_seed = static_cast<uint32_t>(rng.next());
+        inputs.push_back(std::move(input));
+    }
+    return inputs;
+}
+
+std::vector<Orient3dInput> make_orient3d_inputs(std::size_t count, SplitMix64& rng) {
+    std::vector<Orient3dInput> inputs(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        for (double& x : inputs[i].points) {
+            x = std::ldexp(static_cast<double>(rng.next() >> 11U), -52) - 1.0;
+        }
+    }
+    return inputs;
+}
+
+std::vector<Orient3dBatchInput> make_orient3d_batch_inputs(std::size_t count, SplitMix64& rng) {
+    std::vector<Orient3dBatchInput> inputs(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        for (std::vector<double>& c : inputs[i].coords) {
+            c.resize(64);
+            for (double& x : c) {
+                x = std::ldexp(static_cast<double>(rng.next() >> 11U), -52) - 1.0;
+            }
+        }
+        inputs[i].signs.resize(64);
+        inputs[i].uncertain.resize(64);
+    }
+    return inputs;
+}
+
+std::vector<MpfChainInput> make_mpf_chain_inputs(std::size_t count, SplitMix64& rng) {
+    std::vector<MpfChainInput> inputs(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        inputs[i].factors.reserve(32);
+        for (std::size_t j = 0; j < 32; ++j) {
+            inputs[i].factors.push_back(MiniMPF(std::ldexp(static_cast<double>(rng.next() >> 11U), -53) + 0.5));
+        }
+    }
+    return inputs;
+}
+
+std::vector<MpfSumInput> make_mpf_sum_inputs(std::size_t count, SplitMix64& rng) {
+    std::vector<MpfSumInput> inputs(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        inputs[i].terms.reserve(64);
+        for (std::size_t j = 0; j < 64; ++j) {
+            const uint64_t bits = rng.next();
+            const double x = std::ldexp(static_cast<double>(bits >> 11U), -53 + static_cast<int>(bits % 81U) - 40);
+            inputs[i].terms.push_back(MiniMPF((bits & 1024U) != 0U ? -x : x));
+        }
+    }
+    return inputs;
+}
+
+std::vector<MpfDotInput> make_mpf_dot_inputs(std::size_t count, SplitMix64& rng) {
+    std::vector<MpfDotInput> inputs(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        for (std::size_t j = 0; j < 64; ++j) {
+            const uint64_t bits = rng.next();
+            const double x = std::ldexp(static_cast<double>(bits >> 11U), -53 + static_cast<int>(bits % 81U) - 40);
+            (j < 32 ? inputs[i].lhs[j] : inputs[i].rhs[j - 32]) = MiniMPF((bits & 1024U) != 0U ? -x : x);
+        }
+    }
+    return inputs;
+}
+
+std::vector<MpfDot16Input> make_mpf_dot16_inputs(std::size_t count, SplitMix64& rng) {
+    std::vector<MpfDot16Input> inputs(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        for (std::size_t j = 0; j < 32; ++j) {
+            const uint64_t bits = rng.next();
+            const double x = std::ldexp(static_cast<double>(bits >> 11U), -53 + static_cast<int>(bits % 61U) - 30);
+            (j < 16 ? inputs[i].lhs[j] : inputs[i].rhs[j - 16]) = MiniMPF((bits & 1024U) != 0U ? -x : x);
+        }
+    }
+    return inputs;
+}
+
+std::vector<AddmulBatchInput> make_addmul_batch_inputs(std::size_t count, SplitMix64& rng) {
+    const mp_size_t n = AddmulBatchInput::count;
+    const mp_size_t limbs = AddmulBatchInput::limbs;
+    std::vector<AddmulBatchInput> inputs(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        AddmulBatchInput& input = inputs[i];
+        input.operands.resize(n * limbs);
+        input.interleaved.resize(n * limbs);
+        input.multipliers.resize(n);
+        input.accumulators.assign(n * limbs, 0);
+        input.carries.assign(n, 0);
+        for (mp_size_t k = 0; k < n; ++k) {
+            input.multipliers[k] = rng.next();
+            for (mp_size_t j = 0; j < limbs; ++j) {
+                input.operands[k * limbs + j] = input.interleaved[j * n + k] = rng.next();
+            }
+        }
+    }
+    return inputs;
+}
+
+std::vector<Mul2048Input> make_mul2048_inputs(std::size_t count, SplitMix64& rng) {
+    std::vector<Mul2048Input> inputs(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        Mul2048Input& input = inputs[i];
+        for (mp_size_t j = 0; j < Mul2048Input::limbs; ++j) {
+            input.a[j] = rng.next();
+            input.b[j] = rng.next();
+            input.m[j] = rng.next();
+        }
+        const mp_size_t top = Mul2048Input::limbs - 1;
+        input.m[0] |= 1U;
+        input.m[top] |= static_cast<mp_limb_t>(1) << 63U;
+        input.a[top] &= ~(static_cast<mp_limb_t>(1) << 63U);
+        input.b[top] &= ~(static_cast<mp_limb_t>(1) << 63U);
+    }
+    return inputs;
+}
+
+std::vector<MpfSortInput> make_mpf_sort_inputs(SplitMix64& rng) {
+    std::vector<MpfSortInput> inputs(1);
+    inputs[0].values.reserve(1000000);
+    for (std::size_t j = 0; j < 1000000; ++j) {
+        const uint64_t bits = rng.next();
+        const int exponent = static_cast<int>(bits % 81U) - 40;
+        if ((j & 3U) == 0U) {
+            inputs[0].values.push_back(MiniMPF(make_random_value(rng, 128U, true), exponent - 128));
+        } else {
+            const double x = std::ldexp(static_cast<double>(bits >> 11U), exponent - 53);
+            inputs[0].values.push_back(MiniMPF((bits & 1024U) != 0U ? -x : x));
+        }
+    }
+    inputs[0].shuffle_seed = static_cast<uint32_t>(rng.next());
+    return inputs;
+}
+
+MiniMPZ mpf_chain_value(const MpfChainInput& input) {
+    MiniMPF p(1.0);
+    for (std::size_t i = 0; i < input.factors.size(); ++i) {
+        p = fma(p, input.factors[i], input.factors[i]);
+    }
+    return p.Mantisse();
+}
+
 uint64_t update_checksum(uint64_t checksum, const MiniMPZ& value) {
     checksum ^= static_cast<uint64_t>(mpz_get_ui(value.get_mpz())) + 0x9e3779b97f4a7c15ULL + (checksum << 6U) + (checksum >> 2U);
     return checksum * 1099511628211ULL;
@@ -337,14 +589,26 @@ int main(int argc, char** argv) {
         const std::vector<Det2Input> det2_inputs = make_det2_inputs(options.dataset_size, rng);
         const std::vector<Det3Input> det3_inputs = make_det3_inputs(options.dataset_size, rng);
         const std::vector<Det4Input> det4_inputs = make_det4_inputs(options.dataset_size, rng);
+        const std::vector<Det16Input> det16_inputs = make_det16_inputs(options.dataset_size, rng);
         const std::vector<SqrtInput> sqrt_inputs = make_sqrt_inputs(options.dataset_size, rng);
         const std::vector<GcdInput> gcd_inputs = make_gcd_inputs(options.dataset_size, rng);
+        const std::vector<MoveInput> move_inputs = make_move_inputs(options.dataset_size, rng);
+        const std::vector<Orient3dInput> orient3d_inputs = make_orient3d_inputs(options.dataset_size, rng);
+        const std::vector<Orient3dBatchInput> orient3d_batch_inputs = make_orient3d_batch_inputs(options.dataset_size, rng);
+        const std::vector<MpfChainInput> mpf_chain_inputs = make_mpf_chain_inputs(options.dataset_size, rng);
+        const std::vector<MpfSumInput> mpf_sum_inputs = make_mpf_sum_inputs(options.dataset_size, rng);
+        const std::vector<MpfDotInput> mpf_dot_inputs = make_mpf_dot_inputs(options.dataset_size, rng);
+        const std::vector<MpfDot16Input> mpf_dot16_inputs = make_mpf_dot16_inputs(options.dataset_size, rng);
+        const std::vector<MpfSortInput> mpf_sort_inputs = make_mpf_sort_inputs(rng);
+        const std::vector<AddmulBatchInput> addmul_batch_inputs = make_addmul_batch_inputs(options.dataset_size, rng);
+        const std::vector<Mul2048Input> mul2048_inputs = make_mul2048_inputs(options.dataset_size, rng);
 
         std::cout << "mini-gmp-plus geometry benchmark\n";
         std::cout << "Variant       : " << MINI_GMP_PLUS_BENCHMARK_VARIANT << '\n';
+        std::cout << "SIMD level    : " << mini_gmp_simd_level() << '\n';
         std::cout << "Dataset size  : " << options.dataset_size << '\n';
         std::cout << "Min time/case : " << options.min_time_ms << " ms\n";
-        std::cout << "Workloads     : dot4(80-bit coords), det2(96-bit entries), det3(64-bit entries), det4(48-bit entries), sqrt(~384-bit radicands), gcd(~224-bit inputs)\n\n";
+        std::cout << "Workloads     : dot4(80-bit coords), det2(96-bit entries), det3(64-bit entries), det4(48-bit entries), det16 Bareiss/multi-modular(48-bit entries), sqrt(~384-bit radicands), gcd(~224-bit inputs), sort/vector growth(64 values, 128/448-bit), orient3d filtered/exact/expansion/batch-64(random doubles), mpf fma chain exact/113-bit(32 doubles), mpf sum/dot(64 doubles, mixed exponents), mpf sort(1M values), mpf hash set(64 doubles), addmul_1 loop/batch(64 x 256-bit), mpn_add_n/mpn_sub_n/mpn_lshift/mpn_rshift/mpn_mul/mpn_montmul(2048-bit)\n\n";
 
         std::cout << std::left << std::setw(24) << "Benchmark"
                   << std::right << std::setw(12) << "ops"
@@ -373,6 +637,16 @@ int main(int argc, char** argv) {
                                        return mini_gmp_plus_geometry::determinant4(input.matrix);
                                    },
                                    options.min_time_ms));
+        print_result(run_benchmark("determinant-16x16", det16_inputs,
+                                   [](const Det16Input& input) {
+                                       return input.matrix.determinant();
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("determinant-16x16-modular", det16_inputs,
+                                   [](const Det16Input& input) {
+                                       return mini_gmp_plus_modular::determinant(input.matrix);
+                                   },
+                                   options.min_time_ms));
         print_result(run_benchmark("sqrt", sqrt_inputs,
                                    [](const SqrtInput& input) {
                                        return input.value.sqrt();
@@ -383,6 +657,163 @@ int main(int argc, char** argv) {
                                        return mini_gmp_plus_geometry::gcd_value(input.lhs, input.rhs);
                                    },
                                    options.min_time_ms));
+        print_result(run_benchmark("orient3d-filtered", orient3d_inputs,
+                                   [](const Orient3dInput& input) {
+                                       const double* p = input.points;
+                                       return MiniMPZ(static_cast<long>(mini_gmp_plus_predicates::orient3d(p, p + 3, p + 6, p + 9)));
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("orient3d-exact", orient3d_inputs,
+                                   [](const Orient3dInput& input) {
+                                       const double* p = input.points;
+                                       return MiniMPZ(static_cast<long>(mini_gmp_plus_predicates::orient3d_exact(p, p + 3, p + 6, p + 9)));
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("orient3d-expansion", orient3d_inputs,
+                                   [](const Orient3dInput& input) {
+                                       const double* p = input.points;
+                                       int sign = 0;
+                                       mini_gmp_plus_predicates::orient3d_expansion(p, p + 3, p + 6, p + 9, sign);
+                                       return MiniMPZ(static_cast<long>(sign));
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("orient3d-batch-64", orient3d_batch_inputs,
+                                   [](const Orient3dBatchInput& input) {
+                                       const std::vector<double>* c = input.coords;
+                                       const mini_gmp_plus_predicates::Orient3dBatch batch = {
+                                           c[0].data(), c[1].data(), c[2].data(), c[3].data(),
+                                           c[4].data(), c[5].data(), c[6].data(), c[7].data(),
+                                           c[8].data(), c[9].data(), c[10].data(), c[11].data(), 64
+                                       };
+                                       mini_gmp_plus_predicates::orient3d_batch(batch, input.signs.data(), input.uncertain.data());
+                                       long positive = 0;
+                                       for (int sign : input.signs) {
+                                           positive += sign > 0;
+                                       }
+                                       return MiniMPZ(positive);
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("mpf-chain-32-exact", mpf_chain_inputs,
+                                   [](const MpfChainInput& input) {
+                                       return mpf_chain_value(input);
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("mpf-chain-32-113bit", mpf_chain_inputs,
+                                   [](const MpfChainInput& input) {
+                                       const MiniMPFPrecisionScope limit(113);
+                                       return mpf_chain_value(input);
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("mpf-sum-64", mpf_sum_inputs,
+                                   [](const MpfSumInput& input) {
+                                       MiniMPF sum;
+                                       for (std::size_t i = 0; i < input.terms.size(); ++i) {
+                                           sum += input.terms[i];
+                                       }
+                                       return sum.Mantisse();
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("mpf-dot-32", mpf_dot_inputs,
+                                   [](const MpfDotInput& input) {
+                                       return dot_product_fused(input.lhs, input.rhs).Mantisse();
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("mpf-dot-16", mpf_dot16_inputs,
+                                   [](const MpfDot16Input& input) {
+                                       return dot_product_fused(input.lhs, input.rhs).Mantisse();
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("mpf-sort-1M", mpf_sort_inputs,
+                                   [](const MpfSortInput& input) {
+                                       std::minstd_rand shuffle_rng(input.shuffle_seed);
+                                       std::shuffle(input.values.begin(), input.values.end(), shuffle_rng);
+                                       std::sort(input.values.begin(), input.values.end());
+                                       return input.values[input.values.size() / 2].Mantisse();
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("mpf-hash-set-64", mpf_sum_inputs,
+                                   [](const MpfSumInput& input) {
+                                       std::unordered_set<MiniMPF> set(input.terms.begin(), input.terms.end());
+                                       return MiniMPZ(static_cast<unsigned long>(set.size()));
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("addmul_1-64x4-loop", addmul_batch_inputs,
+                                   [](const AddmulBatchInput& input) {
+                                       const mp_size_t limbs = AddmulBatchInput::limbs;
+                                       for (mp_size_t k = 0; k < AddmulBatchInput::count; ++k) {
+                                           input.carries[k] = mpn_addmul_1(&input.accumulators[k * limbs],
+                                                                            &input.operands[k * limbs], limbs,
+                                                                            input.multipliers[k]);
+                                       }
+                                       return MiniMPZ(static_cast<unsigned long>(input.carries[7]));
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("addmul_1-64x4-batch", addmul_batch_inputs,
+                                   [](const AddmulBatchInput& input) {
+                                       mpn_addmul_1_batch(input.accumulators.data(), input.interleaved.data(),
+                                                          AddmulBatchInput::limbs, input.multipliers.data(),
+                                                          input.carries.data(), AddmulBatchInput::count);
+                                       return MiniMPZ(static_cast<unsigned long>(input.carries[7]));
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("mpn-mul-2048", mul2048_inputs,
+                                   [](const Mul2048Input& input) {
+                                       mpn_mul_n(input.r.data(), input.a.data(), input.b.data(), Mul2048Input::limbs);
+                                       return MiniMPZ(static_cast<unsigned long>(input.r[Mul2048Input::limbs]));
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("mpn-add_n-2048", mul2048_inputs,
+                                   [](const Mul2048Input& input) {
+                                       const mp_limb_t cy = mpn_add_n(input.r.data(), input.a.data(), input.b.data(),
+                                                                      Mul2048Input::limbs);
+                                       return MiniMPZ(static_cast<unsigned long>(input.r[0] + cy));
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("mpn-sub_n-2048", mul2048_inputs,
+                                   [](const Mul2048Input& input) {
+                                       const mp_limb_t cy = mpn_sub_n(input.r.data(), input.a.data(), input.b.data(),
+                                                                      Mul2048Input::limbs);
+                                       return MiniMPZ(static_cast<unsigned long>(input.r[0] + cy));
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("mpn-lshift-2048", mul2048_inputs,
+                                   [](const Mul2048Input& input) {
+                                       const mp_limb_t out = mpn_lshift(input.r.data(), input.a.data(),
+                                                                        Mul2048Input::limbs, 13);
+                                       return MiniMPZ(static_cast<unsigned long>(input.r[0] + out));
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("mpn-rshift-2048", mul2048_inputs,
+                                   [](const Mul2048Input& input) {
+                                       const mp_limb_t out = mpn_rshift(input.r.data(), input.a.data(),
+                                                                        Mul2048Input::limbs, 13);
+                                       return MiniMPZ(static_cast<unsigned long>(input.r[0] + out));
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("mpn-montmul-2048", mul2048_inputs,
+                                   [](const Mul2048Input& input) {
+                                       mpn_montmul(input.r.data(), input.a.data(), input.b.data(), input.m.data(),
+                                                   Mul2048Input::limbs);
+                                       return MiniMPZ(static_cast<unsigned long>(input.r[0]));
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("sort-64", move_inputs,
+                                   [](const MoveInput& input) {
+                                       std::minstd_rand shuffle_rng(input.shuffle_seed);
+                                       std::shuffle(input.values.begin(), input.values.end(), shuffle_rng);
+                                       std::sort(input.values.begin(), input.values.end());
+                                       return input.values.front();
+                                   },
+                                   options.min_time_ms));
+        print_result(run_benchmark("vector-growth-64", move_inputs,
+                                   [](const MoveInput& input) {
+                                       std::vector<MiniMPZ> grown;
+                                       for (std::size_t i = 0; i < input.values.size(); ++i) {
+                                           grown.push_back(input.values[i]);
+                                       }
+                                       return grown.back();
+                                   },
+                                   options.min_time_ms));
 
         std::cout << "\nSink checksum : 0x" << std::hex << benchmark_sink << std::dec << '\n';
     } catch (const std::exception& e) {
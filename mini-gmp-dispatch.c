@@ -0,0 +1,1243 @@
+/* mini-gmp-dispatch.c — runtime selection of the vectorizable mpn kernels.
+
+   mpn_popcount, mpn_hamdist, mpn_and_n, mpn_ior_n, mpn_xor_n, mpn_com and
+   mpn_zero_p, and the batched mpn_mul_1_batch / mpn_addmul_1_batch, go
+   through a table of function pointers chosen once, on first use, from the
+   instruction sets the CPU reports:
+
+     "avx512"  AVX-512F (and VPOPCNTDQ for the popcounts, IFMA for
+               mpn_mul / mpn_sqr / mpn_montmul, when present)
+     "avx2"    AVX2
+     "xsimd"   the xsimd kernels of mini-gmp-simd.cpp, built for the
+               compiler's target (MINI_GMP_SIMD builds only)
+     "scalar"  plain C
+
+   The AVX2 and AVX-512 kernels are compiled with target attributes, so a
+   baseline x86-64 build still uses them on capable hosts and a single
+   binary runs everywhere.  They exist only for GCC/Clang on x86-64.
+
+   The MINI_GMP_SIMD_LEVEL environment variable caps the level (e.g.
+   MINI_GMP_SIMD_LEVEL=scalar to benchmark without SIMD);
+   mini_gmp_set_simd_level does the same at run time.  Operands shorter than
+   MINI_GMP_DISPATCH_THRESHOLD limbs use the scalar code directly.
+
+   mpn_mul and mpn_montmul stay in mini-gmp.c and ask for a kernel through
+   mini_gmp_dispatch_mul / mini_gmp_dispatch_montmul, which return 0 when
+   the active level has none for that size.  Likewise mpn_add_n and
+   mpn_sub_n (in mini-gmp.c or mini-gmp-simd.cpp) call
+   mini_gmp_dispatch_add_n / mini_gmp_dispatch_sub_n, which return -1 when
+   the operands are too short for the carry-save kernels to pay off, and
+   mpn_lshift / mpn_rshift call mini_gmp_dispatch_lshift /
+   mini_gmp_dispatch_rshift, which return 0 in that case. */
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mini-gmp.h"
+#include "mini-gmp-dispatch.h"
+#include "bitops64.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#  define MINI_GMP_X86_DISPATCH 1
+#  include <immintrin.h>
+#else
+#  define MINI_GMP_X86_DISPATCH 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#  define MINI_GMP_LOAD_PTR(p) __atomic_load_n (&(p), __ATOMIC_ACQUIRE)
+#  define MINI_GMP_STORE_PTR(p, v) __atomic_store_n (&(p), (v), __ATOMIC_RELEASE)
+#else
+#  define MINI_GMP_LOAD_PTR(p) (p)
+#  define MINI_GMP_STORE_PTR(p, v) ((p) = (v))
+#endif
+
+#define MINI_GMP_DISPATCH_THRESHOLD 8
+
+struct mini_gmp_kernels
+{
+  const char *name;
+  mp_bitcnt_t (*popcount) (mp_srcptr, mp_size_t);
+  mp_bitcnt_t (*hamdist) (mp_srcptr, mp_srcptr, mp_size_t);
+  void (*and_n) (mp_ptr, mp_srcptr, mp_srcptr, mp_size_t);
+  void (*ior_n) (mp_ptr, mp_srcptr, mp_srcptr, mp_size_t);
+  void (*xor_n) (mp_ptr, mp_srcptr, mp_srcptr, mp_size_t);
+  void (*com) (mp_ptr, mp_srcptr, mp_size_t);
+  int (*zero_p) (mp_srcptr, mp_size_t);
+  void (*mul_1_batch) (mp_ptr, mp_srcptr, mp_size_t, mp_srcptr, mp_ptr, mp_size_t);
+  void (*addmul_1_batch) (mp_ptr, mp_srcptr, mp_size_t, mp_srcptr, mp_ptr, mp_size_t);
+  /* Optional, NULL when the level has none */
+  mp_limb_t (*add_n) (mp_ptr, mp_srcptr, mp_srcptr, mp_size_t);
+  mp_limb_t (*sub_n) (mp_ptr, mp_srcptr, mp_srcptr, mp_size_t);
+  void (*lshift) (mp_ptr, mp_srcptr, mp_size_t, unsigned);
+  void (*rshift) (mp_ptr, mp_srcptr, mp_size_t, unsigned);
+  void (*mul) (mp_ptr, mp_srcptr, mp_size_t, mp_srcptr, mp_size_t);
+  void (*montmul) (mp_ptr, mp_srcptr, mp_srcptr, mp_srcptr, mp_size_t, mp_limb_t);
+};
+
+
+/* Scalar kernels */
+
+static unsigned
+popcount_limb (mp_limb_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return (unsigned) __builtin_popcountll (x);
+#else
+  x -= (x >> 1) & 0x5555555555555555ULL;
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  return (unsigned) ((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+static mp_bitcnt_t
+scalar_popcount (mp_srcptr p, mp_size_t n)
+{
+  mp_bitcnt_t c = 0;
+  mp_size_t i;
+  for (i = 0; i < n; i++)
+    c += popcount_limb (p[i]);
+  return c;
+}
+
+static mp_bitcnt_t
+scalar_hamdist (mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+{
+  mp_bitcnt_t c = 0;
+  mp_size_t i;
+  for (i = 0; i < n; i++)
+    c += popcount_limb (ap[i] ^ bp[i]);
+  return c;
+}
+
+static void
+scalar_and_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+{
+  while (--n >= 0)
+    rp[n] = ap[n] & bp[n];
+}
+
+static void
+scalar_ior_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+{
+  while (--n >= 0)
+    rp[n] = ap[n] | bp[n];
+}
+
+static void
+scalar_xor_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+{
+  while (--n >= 0)
+    rp[n] = ap[n] ^ bp[n];
+}
+
+static void
+scalar_com (mp_ptr rp, mp_srcptr up, mp_size_t n)
+{
+  while (--n >= 0)
+    *rp++ = ~ *up++;
+}
+
+static int
+scalar_zero_p (mp_srcptr rp, mp_size_t n)
+{
+  while (n > 0)
+    if (rp[--n] != 0)
+      return 0;
+  return 1;
+}
+
+/* Tails of the vector add_n / sub_n, with carry / borrow in. */
+static mp_limb_t
+scalar_add_nc (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n, mp_limb_t cy)
+{
+  mp_size_t i;
+  for (i = 0; i < n; i++)
+    {
+      mp_limb_t r = ap[i] + cy;
+      cy = r < cy;
+      r += bp[i];
+      cy += r < bp[i];
+      rp[i] = r;
+    }
+  return cy;
+}
+
+static mp_limb_t
+scalar_sub_nc (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n, mp_limb_t cy)
+{
+  mp_size_t i;
+  for (i = 0; i < n; i++)
+    {
+      mp_limb_t b = bp[i] + cy;
+      cy = b < cy;
+      cy += ap[i] < b;
+      rp[i] = ap[i] - b;
+    }
+  return cy;
+}
+
+/* Batched products on `lanes` interleaved operands, limb i of operand k at
+   index i * stride + k.  Looping over the operands innermost keeps the
+   carries independent, so the multiplies pipeline. */
+static void
+scalar_aorsmul_1_batch (mp_ptr rp, mp_srcptr up, mp_size_t n, mp_srcptr vp,
+			mp_ptr cp, mp_size_t lanes, mp_size_t stride, int add)
+{
+  mp_size_t i, k;
+
+  for (k = 0; k < lanes; k++)
+    cp[k] = 0;
+  for (i = 0; i < n; i++, rp += stride, up += stride)
+    for (k = 0; k < lanes; k++)
+      {
+	mp_limb_t hi, lo;
+#if defined(__GNUC__)
+	bitops64_uint128_t product = (bitops64_uint128_t) up[k] * vp[k];
+	lo = (mp_limb_t) product;
+	hi = (mp_limb_t) (product >> 64);
+#else
+	lo = _umul128 (up[k], vp[k], &hi);
+#endif
+	lo += cp[k];
+	hi += lo < cp[k];
+	if (add)
+	  {
+	    lo += rp[k];
+	    hi += lo < rp[k];
+	  }
+	rp[k] = lo;
+	cp[k] = hi;
+      }
+}
+
+static void
+scalar_mul_1_batch (mp_ptr rp, mp_srcptr up, mp_size_t n, mp_srcptr vp,
+		    mp_ptr cp, mp_size_t count)
+{
+  scalar_aorsmul_1_batch (rp, up, n, vp, cp, count, count, 0);
+}
+
+static void
+scalar_addmul_1_batch (mp_ptr rp, mp_srcptr up, mp_size_t n, mp_srcptr vp,
+		       mp_ptr cp, mp_size_t count)
+{
+  scalar_aorsmul_1_batch (rp, up, n, vp, cp, count, count, 1);
+}
+
+static const struct mini_gmp_kernels kernels_scalar = {
+  "scalar", scalar_popcount, scalar_hamdist, scalar_and_n, scalar_ior_n,
+  scalar_xor_n, scalar_com, scalar_zero_p, scalar_mul_1_batch,
+  scalar_addmul_1_batch, NULL, NULL, NULL, NULL, NULL, NULL
+};
+
+
+/* xsimd kernels (mini-gmp-simd.cpp) */
+
+#ifdef MINI_GMP_SIMD
+mp_bitcnt_t mini_gmp_xsimd_popcount (mp_srcptr, mp_size_t);
+mp_bitcnt_t mini_gmp_xsimd_hamdist (mp_srcptr, mp_srcptr, mp_size_t);
+void mini_gmp_xsimd_and_n (mp_ptr, mp_srcptr, mp_srcptr, mp_size_t);
+void mini_gmp_xsimd_ior_n (mp_ptr, mp_srcptr, mp_srcptr, mp_size_t);
+void mini_gmp_xsimd_xor_n (mp_ptr, mp_srcptr, mp_srcptr, mp_size_t);
+void mini_gmp_xsimd_com (mp_ptr, mp_srcptr, mp_size_t);
+int mini_gmp_xsimd_zero_p (mp_srcptr, mp_size_t);
+
+static const struct mini_gmp_kernels kernels_xsimd = {
+  "xsimd", mini_gmp_xsimd_popcount, mini_gmp_xsimd_hamdist,
+  mini_gmp_xsimd_and_n, mini_gmp_xsimd_ior_n, mini_gmp_xsimd_xor_n,
+  mini_gmp_xsimd_com, mini_gmp_xsimd_zero_p, scalar_mul_1_batch,
+  scalar_addmul_1_batch, NULL, NULL, NULL, NULL, NULL, NULL
+};
+#endif
+
+
+#if MINI_GMP_X86_DISPATCH
+
+/* AVX2 kernels.  The popcount uses the nibble lookup table with vpshufb and
+   sums the bytes of each 64-bit lane with vpsadbw (Mula et al.). */
+
+#define MINI_GMP_AVX2 __attribute__ ((target ("avx2")))
+
+MINI_GMP_AVX2 static __m256i
+avx2_popcount_lanes (__m256i v)
+{
+  const __m256i table = _mm256_setr_epi8 (0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+					  0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low = _mm256_set1_epi8 (0x0f);
+  const __m256i lo = _mm256_shuffle_epi8 (table, _mm256_and_si256 (v, low));
+  const __m256i hi = _mm256_shuffle_epi8 (table, _mm256_and_si256 (_mm256_srli_epi16 (v, 4), low));
+  return _mm256_sad_epu8 (_mm256_add_epi8 (lo, hi), _mm256_setzero_si256 ());
+}
+
+MINI_GMP_AVX2 static mp_bitcnt_t
+avx2_reduce (__m256i acc)
+{
+  const __m128i s = _mm_add_epi64 (_mm256_castsi256_si128 (acc), _mm256_extracti128_si256 (acc, 1));
+  return (mp_bitcnt_t) (_mm_cvtsi128_si64 (s) + _mm_extract_epi64 (s, 1));
+}
+
+MINI_GMP_AVX2 static mp_bitcnt_t
+avx2_popcount (mp_srcptr p, mp_size_t n)
+{
+  __m256i acc = _mm256_setzero_si256 ();
+  mp_size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    acc = _mm256_add_epi64 (acc, avx2_popcount_lanes (_mm256_loadu_si256 ((const __m256i *) (p + i))));
+  return avx2_reduce (acc) + scalar_popcount (p + i, n - i);
+}
+
+MINI_GMP_AVX2 static mp_bitcnt_t
+avx2_hamdist (mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+{
+  __m256i acc = _mm256_setzero_si256 ();
+  mp_size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    acc = _mm256_add_epi64 (acc, avx2_popcount_lanes (
+			      _mm256_xor_si256 (_mm256_loadu_si256 ((const __m256i *) (ap + i)),
+						_mm256_loadu_si256 ((const __m256i *) (bp + i)))));
+  return avx2_reduce (acc) + scalar_hamdist (ap + i, bp + i, n - i);
+}
+
+#define MINI_GMP_AVX2_LOGOP(name, op, scalar)				\
+  MINI_GMP_AVX2 static void						\
+  name (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)		\
+  {									\
+    mp_size_t i = 0;							\
+    for (; i + 4 <= n; i += 4)						\
+      _mm256_storeu_si256 ((__m256i *) (rp + i),			\
+			   op (_mm256_loadu_si256 ((const __m256i *) (ap + i)), \
+			       _mm256_loadu_si256 ((const __m256i *) (bp + i)))); \
+    scalar (rp + i, ap + i, bp + i, n - i);				\
+  }
+
+MINI_GMP_AVX2_LOGOP (avx2_and_n, _mm256_and_si256, scalar_and_n)
+MINI_GMP_AVX2_LOGOP (avx2_ior_n, _mm256_or_si256, scalar_ior_n)
+MINI_GMP_AVX2_LOGOP (avx2_xor_n, _mm256_xor_si256, scalar_xor_n)
+
+MINI_GMP_AVX2 static void
+avx2_com (mp_ptr rp, mp_srcptr up, mp_size_t n)
+{
+  const __m256i ones = _mm256_set1_epi64x (-1);
+  mp_size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_si256 ((__m256i *) (rp + i),
+			 _mm256_xor_si256 (_mm256_loadu_si256 ((const __m256i *) (up + i)), ones));
+  scalar_com (rp + i, up + i, n - i);
+}
+
+/* Scans from the most significant end, where normalized numbers are
+   non-zero. */
+MINI_GMP_AVX2 static int
+avx2_zero_p (mp_srcptr rp, mp_size_t n)
+{
+  while (n >= 4)
+    {
+      const __m256i v = _mm256_loadu_si256 ((const __m256i *) (rp + n - 4));
+      if (!_mm256_testz_si256 (v, v))
+	return 0;
+      n -= 4;
+    }
+  return scalar_zero_p (rp, n);
+}
+
+/* Batched products, one operand per 64-bit lane.  Neither AVX2 nor
+   AVX-512F has a 64x64->128 multiply, so u * v + r + c is assembled from
+   four 32x32->64 products (vpmuludq).  Splitting the additions at bit 32
+   keeps every partial sum below 2^64, so no carry ever needs a compare:
+
+     t0 = ll + r.lo + c.lo
+     t1 = t0 >> 32 + lh.lo + hl.lo + r.hi + c.hi
+     lo = t0.lo | t1 << 32
+     hi = hh + lh >> 32 + hl >> 32 + t1 >> 32
+
+   The AVX-512 kernel below is the same code on 8 lanes. */
+
+MINI_GMP_AVX2 static inline __attribute__ ((always_inline)) __m256i
+avx2_mul_step (__m256i u, __m256i v, __m256i vh, __m256i r, __m256i *c)
+{
+  const __m256i low = _mm256_set1_epi64x (0xffffffff);
+  const __m256i uh = _mm256_srli_epi64 (u, 32);
+  const __m256i ll = _mm256_mul_epu32 (u, v);
+  const __m256i lh = _mm256_mul_epu32 (u, vh);
+  const __m256i hl = _mm256_mul_epu32 (uh, v);
+  const __m256i hh = _mm256_mul_epu32 (uh, vh);
+  const __m256i t0 = _mm256_add_epi64 (_mm256_add_epi64 (ll, _mm256_and_si256 (r, low)),
+				       _mm256_and_si256 (*c, low));
+  const __m256i t1 = _mm256_add_epi64 (_mm256_add_epi64 (_mm256_srli_epi64 (t0, 32),
+							 _mm256_and_si256 (lh, low)),
+				       _mm256_add_epi64 (_mm256_and_si256 (hl, low),
+							 _mm256_add_epi64 (_mm256_srli_epi64 (r, 32),
+									   _mm256_srli_epi64 (*c, 32))));
+  *c = _mm256_add_epi64 (_mm256_add_epi64 (hh, _mm256_srli_epi64 (lh, 32)),
+			 _mm256_add_epi64 (_mm256_srli_epi64 (hl, 32), _mm256_srli_epi64 (t1, 32)));
+  return _mm256_or_si256 (_mm256_and_si256 (t0, low), _mm256_slli_epi64 (t1, 32));
+}
+
+/* Runs `groups` vectors of lanes side by side: each carry chain is serial,
+   so two independent chains keep the multipliers busy. */
+MINI_GMP_AVX2 static inline __attribute__ ((always_inline)) void
+avx2_aorsmul_1_lanes (mp_ptr rp, mp_srcptr up, mp_size_t n, mp_srcptr vp,
+		      mp_ptr cp, mp_size_t stride, int add, int groups)
+{
+  __m256i v[2], vh[2], c[2];
+  mp_size_t i;
+  int g;
+
+  for (g = 0; g < groups; g++)
+    {
+      v[g] = _mm256_loadu_si256 ((const __m256i *) (vp + 4 * g));
+      vh[g] = _mm256_srli_epi64 (v[g], 32);
+      c[g] = _mm256_setzero_si256 ();
+    }
+  for (i = 0; i < n; i++, rp += stride, up += stride)
+    for (g = 0; g < groups; g++)
+      {
+	const __m256i u = _mm256_loadu_si256 ((const __m256i *) (up + 4 * g));
+	const __m256i r = add ? _mm256_loadu_si256 ((const __m256i *) (rp + 4 * g)) : _mm256_setzero_si256 ();
+	_mm256_storeu_si256 ((__m256i *) (rp + 4 * g), avx2_mul_step (u, v[g], vh[g], r, &c[g]));
+      }
+  for (g = 0; g < groups; g++)
+    _mm256_storeu_si256 ((__m256i *) (cp + 4 * g), c[g]);
+}
+
+MINI_GMP_AVX2 static void
+avx2_aorsmul_1_batch (mp_ptr rp, mp_srcptr up, mp_size_t n, mp_srcptr vp,
+		      mp_ptr cp, mp_size_t lanes, mp_size_t stride, int add)
+{
+  mp_size_t k = 0;
+  for (; k + 8 <= lanes; k += 8)
+    if (add)
+      avx2_aorsmul_1_lanes (rp + k, up + k, n, vp + k, cp + k, stride, 1, 2);
+    else
+      avx2_aorsmul_1_lanes (rp + k, up + k, n, vp + k, cp + k, stride, 0, 2);
+  if (k + 4 <= lanes)
+    {
+      avx2_aorsmul_1_lanes (rp + k, up + k, n, vp + k, cp + k, stride, add, 1);
+      k += 4;
+    }
+  scalar_aorsmul_1_batch (rp + k, up + k, n, vp + k, cp + k, lanes - k, stride, add);
+}
+
+static void
+avx2_mul_1_batch (mp_ptr rp, mp_srcptr up, mp_size_t n, mp_srcptr vp,
+		  mp_ptr cp, mp_size_t count)
+{
+  avx2_aorsmul_1_batch (rp, up, n, vp, cp, count, count, 0);
+}
+
+static void
+avx2_addmul_1_batch (mp_ptr rp, mp_srcptr up, mp_size_t n, mp_srcptr vp,
+		     mp_ptr cp, mp_size_t count)
+{
+  avx2_aorsmul_1_batch (rp, up, n, vp, cp, count, count, 1);
+}
+
+/* Carry-save addition: the lanes are added independently, then the
+   incoming carries of a whole vector are resolved at once from bit masks
+   of the lanes that generate a carry (s < a) and of those that propagate
+   one (s = ~0):
+
+     t = (g << 1 | carry_in) + p,  carries = t ^ p,  carry_out = t >> W
+
+   Only this integer addition is serial, so long operands run at vector
+   throughput instead of one adc per limb.  Subtraction is the same with
+   borrows (a < b) and zero differences. */
+
+MINI_GMP_AVX2 static inline __attribute__ ((always_inline)) __m256i
+avx2_lane_mask (unsigned m)
+{
+  const __m256i bit = _mm256_setr_epi64x (1, 2, 4, 8);
+  return _mm256_cmpeq_epi64 (_mm256_and_si256 (_mm256_set1_epi64x (m), bit), bit);
+}
+
+MINI_GMP_AVX2 static mp_limb_t
+avx2_add_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+{
+  const __m256i sign = _mm256_set1_epi64x (INT64_MIN);
+  const __m256i ones = _mm256_set1_epi64x (-1);
+  unsigned carry = 0;
+  mp_size_t i = 0;
+
+  for (; i + 4 <= n; i += 4)
+    {
+      const __m256i a = _mm256_loadu_si256 ((const __m256i *) (ap + i));
+      const __m256i s = _mm256_add_epi64 (a, _mm256_loadu_si256 ((const __m256i *) (bp + i)));
+      const unsigned g = (unsigned) _mm256_movemask_pd (_mm256_castsi256_pd (
+			   _mm256_cmpgt_epi64 (_mm256_xor_si256 (a, sign), _mm256_xor_si256 (s, sign))));
+      const unsigned p = (unsigned) _mm256_movemask_pd (_mm256_castsi256_pd (_mm256_cmpeq_epi64 (s, ones)));
+      const unsigned c = (g << 1 | carry) + p;
+      carry = c >> 4;
+      _mm256_storeu_si256 ((__m256i *) (rp + i), _mm256_sub_epi64 (s, avx2_lane_mask (c ^ p)));
+    }
+  return scalar_add_nc (rp + i, ap + i, bp + i, n - i, carry);
+}
+
+MINI_GMP_AVX2 static mp_limb_t
+avx2_sub_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+{
+  const __m256i sign = _mm256_set1_epi64x (INT64_MIN);
+  unsigned borrow = 0;
+  mp_size_t i = 0;
+
+  for (; i + 4 <= n; i += 4)
+    {
+      const __m256i a = _mm256_loadu_si256 ((const __m256i *) (ap + i));
+      const __m256i b = _mm256_loadu_si256 ((const __m256i *) (bp + i));
+      const __m256i d = _mm256_sub_epi64 (a, b);
+      const unsigned g = (unsigned) _mm256_movemask_pd (_mm256_castsi256_pd (
+			   _mm256_cmpgt_epi64 (_mm256_xor_si256 (b, sign), _mm256_xor_si256 (a, sign))));
+      const unsigned p = (unsigned) _mm256_movemask_pd (_mm256_castsi256_pd (
+			   _mm256_cmpeq_epi64 (d, _mm256_setzero_si256 ())));
+      const unsigned c = (g << 1 | borrow) + p;
+      borrow = c >> 4;
+      _mm256_storeu_si256 ((__m256i *) (rp + i), _mm256_add_epi64 (d, avx2_lane_mask (c ^ p)));
+    }
+  return scalar_sub_nc (rp + i, ap + i, bp + i, n - i, borrow);
+}
+
+/* Shifts.  Each result limb depends on two adjacent source limbs only, so
+   the kernels load the operand twice, one limb apart, and have no chain
+   between vectors.  The left shift walks down and the right shift up, as
+   in mini-gmp.c, and every vector is loaded before the store that could
+   clobber it, so the upstream overlaps (rp >= up for lshift, rp <= up for
+   rshift) stay valid.  The caller returns the limb shifted out. */
+
+MINI_GMP_AVX2 static void
+avx2_lshift (mp_ptr rp, mp_srcptr up, mp_size_t n, unsigned cnt)
+{
+  const __m128i l = _mm_cvtsi32_si128 ((int) cnt);
+  const __m128i r = _mm_cvtsi32_si128 ((int) (64 - cnt));
+  mp_size_t i = n;
+
+  for (; i > 4; i -= 4)
+    {
+      const __m256i hi = _mm256_loadu_si256 ((const __m256i *) (up + i - 4));
+      const __m256i lo = _mm256_loadu_si256 ((const __m256i *) (up + i - 5));
+      _mm256_storeu_si256 ((__m256i *) (rp + i - 4),
+			   _mm256_or_si256 (_mm256_sll_epi64 (hi, l), _mm256_srl_epi64 (lo, r)));
+    }
+  while (--i > 0)
+    rp[i] = up[i] << cnt | up[i - 1] >> (64 - cnt);
+  rp[0] = up[0] << cnt;
+}
+
+MINI_GMP_AVX2 static void
+avx2_rshift (mp_ptr rp, mp_srcptr up, mp_size_t n, unsigned cnt)
+{
+  const __m128i r = _mm_cvtsi32_si128 ((int) cnt);
+  const __m128i l = _mm_cvtsi32_si128 ((int) (64 - cnt));
+  mp_size_t i = 0;
+
+  for (; i + 4 < n; i += 4)
+    {
+      const __m256i lo = _mm256_loadu_si256 ((const __m256i *) (up + i));
+      const __m256i hi = _mm256_loadu_si256 ((const __m256i *) (up + i + 1));
+      _mm256_storeu_si256 ((__m256i *) (rp + i),
+			   _mm256_or_si256 (_mm256_srl_epi64 (lo, r), _mm256_sll_epi64 (hi, l)));
+    }
+  for (; i < n - 1; i++)
+    rp[i] = up[i] >> cnt | up[i + 1] << (64 - cnt);
+  rp[n - 1] = up[n - 1] >> cnt;
+}
+
+static const struct mini_gmp_kernels kernels_avx2 = {
+  "avx2", avx2_popcount, avx2_hamdist, avx2_and_n, avx2_ior_n, avx2_xor_n,
+  avx2_com, avx2_zero_p, avx2_mul_1_batch, avx2_addmul_1_batch, avx2_add_n,
+  avx2_sub_n, avx2_lshift, avx2_rshift, NULL, NULL
+};
+
+/* AVX-512 kernels */
+
+#define MINI_GMP_AVX512 __attribute__ ((target ("avx512f")))
+#define MINI_GMP_AVX512_POPCNT __attribute__ ((target ("avx512f,avx512vpopcntdq")))
+
+MINI_GMP_AVX512_POPCNT static mp_bitcnt_t
+avx512_popcount (mp_srcptr p, mp_size_t n)
+{
+  __m512i acc = _mm512_setzero_si512 ();
+  mp_size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    acc = _mm512_add_epi64 (acc, _mm512_popcnt_epi64 (_mm512_loadu_si512 (p + i)));
+  return (mp_bitcnt_t) _mm512_reduce_add_epi64 (acc) + scalar_popcount (p + i, n - i);
+}
+
+MINI_GMP_AVX512_POPCNT static mp_bitcnt_t
+avx512_hamdist (mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+{
+  __m512i acc = _mm512_setzero_si512 ();
+  mp_size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    acc = _mm512_add_epi64 (acc, _mm512_popcnt_epi64 (
+			      _mm512_xor_si512 (_mm512_loadu_si512 (ap + i), _mm512_loadu_si512 (bp + i))));
+  return (mp_bitcnt_t) _mm512_reduce_add_epi64 (acc) + scalar_hamdist (ap + i, bp + i, n - i);
+}
+
+#define MINI_GMP_AVX512_LOGOP(name, op, scalar)				\
+  MINI_GMP_AVX512 static void						\
+  name (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)		\
+  {									\
+    mp_size_t i = 0;							\
+    for (; i + 8 <= n; i += 8)						\
+      _mm512_storeu_si512 (rp + i, op (_mm512_loadu_si512 (ap + i),	\
+				       _mm512_loadu_si512 (bp + i)));	\
+    scalar (rp + i, ap + i, bp + i, n - i);				\
+  }
+
+MINI_GMP_AVX512_LOGOP (avx512_and_n, _mm512_and_si512, scalar_and_n)
+MINI_GMP_AVX512_LOGOP (avx512_ior_n, _mm512_or_si512, scalar_ior_n)
+MINI_GMP_AVX512_LOGOP (avx512_xor_n, _mm512_xor_si512, scalar_xor_n)
+
+MINI_GMP_AVX512 static void
+avx512_com (mp_ptr rp, mp_srcptr up, mp_size_t n)
+{
+  const __m512i ones = _mm512_set1_epi64 (-1);
+  mp_size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm512_storeu_si512 (rp + i, _mm512_xor_si512 (_mm512_loadu_si512 (up + i), ones));
+  scalar_com (rp + i, up + i, n - i);
+}
+
+MINI_GMP_AVX512 static int
+avx512_zero_p (mp_srcptr rp, mp_size_t n)
+{
+  while (n >= 8)
+    {
+      const __m512i v = _mm512_loadu_si512 (rp + n - 8);
+      if (_mm512_test_epi64_mask (v, v) != 0)
+	return 0;
+      n -= 8;
+    }
+  return scalar_zero_p (rp, n);
+}
+
+MINI_GMP_AVX512 static inline __attribute__ ((always_inline)) __m512i
+avx512_mul_step (__m512i u, __m512i v, __m512i vh, __m512i r, __m512i *c)
+{
+  const __m512i low = _mm512_set1_epi64 (0xffffffff);
+  const __m512i uh = _mm512_srli_epi64 (u, 32);
+  const __m512i ll = _mm512_mul_epu32 (u, v);
+  const __m512i lh = _mm512_mul_epu32 (u, vh);
+  const __m512i hl = _mm512_mul_epu32 (uh, v);
+  const __m512i hh = _mm512_mul_epu32 (uh, vh);
+  const __m512i t0 = _mm512_add_epi64 (_mm512_add_epi64 (ll, _mm512_and_si512 (r, low)),
+				       _mm512_and_si512 (*c, low));
+  const __m512i t1 = _mm512_add_epi64 (_mm512_add_epi64 (_mm512_srli_epi64 (t0, 32),
+							 _mm512_and_si512 (lh, low)),
+				       _mm512_add_epi64 (_mm512_and_si512 (hl, low),
+							 _mm512_add_epi64 (_mm512_srli_epi64 (r, 32),
+									   _mm512_srli_epi64 (*c, 32))));
+  *c = _mm512_add_epi64 (_mm512_add_epi64 (hh, _mm512_srli_epi64 (lh, 32)),
+			 _mm512_add_epi64 (_mm512_srli_epi64 (hl, 32), _mm512_srli_epi64 (t1, 32)));
+  return _mm512_or_si512 (_mm512_and_si512 (t0, low), _mm512_slli_epi64 (t1, 32));
+}
+
+MINI_GMP_AVX512 static inline __attribute__ ((always_inline)) void
+avx512_aorsmul_1_lanes (mp_ptr rp, mp_srcptr up, mp_size_t n, mp_srcptr vp,
+			mp_ptr cp, mp_size_t stride, int add, int groups)
+{
+  __m512i v[2], vh[2], c[2];
+  mp_size_t i;
+  int g;
+
+  for (g = 0; g < groups; g++)
+    {
+      v[g] = _mm512_loadu_si512 (vp + 8 * g);
+      vh[g] = _mm512_srli_epi64 (v[g], 32);
+      c[g] = _mm512_setzero_si512 ();
+    }
+  for (i = 0; i < n; i++, rp += stride, up += stride)
+    for (g = 0; g < groups; g++)
+      {
+	const __m512i u = _mm512_loadu_si512 (up + 8 * g);
+	const __m512i r = add ? _mm512_loadu_si512 (rp + 8 * g) : _mm512_setzero_si512 ();
+	_mm512_storeu_si512 (rp + 8 * g, avx512_mul_step (u, v[g], vh[g], r, &c[g]));
+      }
+  for (g = 0; g < groups; g++)
+    _mm512_storeu_si512 (cp + 8 * g, c[g]);
+}
+
+MINI_GMP_AVX512 static void
+avx512_aorsmul_1_batch (mp_ptr rp, mp_srcptr up, mp_size_t n, mp_srcptr vp,
+			mp_ptr cp, mp_size_t count, int add)
+{
+  mp_size_t k = 0;
+  for (; k + 16 <= count; k += 16)
+    if (add)
+      avx512_aorsmul_1_lanes (rp + k, up + k, n, vp + k, cp + k, count, 1, 2);
+    else
+      avx512_aorsmul_1_lanes (rp + k, up + k, n, vp + k, cp + k, count, 0, 2);
+  if (k + 8 <= count)
+    {
+      avx512_aorsmul_1_lanes (rp + k, up + k, n, vp + k, cp + k, count, add, 1);
+      k += 8;
+    }
+  if (k < count)
+    avx2_aorsmul_1_batch (rp + k, up + k, n, vp + k, cp + k, count - k, count, add);
+}
+
+static void
+avx512_mul_1_batch (mp_ptr rp, mp_srcptr up, mp_size_t n, mp_srcptr vp,
+		    mp_ptr cp, mp_size_t count)
+{
+  avx512_aorsmul_1_batch (rp, up, n, vp, cp, count, 0);
+}
+
+static void
+avx512_addmul_1_batch (mp_ptr rp, mp_srcptr up, mp_size_t n, mp_srcptr vp,
+		       mp_ptr cp, mp_size_t count)
+{
+  avx512_aorsmul_1_batch (rp, up, n, vp, cp, count, 1);
+}
+
+MINI_GMP_AVX512 static mp_limb_t
+avx512_add_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+{
+  const __m512i ones = _mm512_set1_epi64 (-1);
+  unsigned carry = 0;
+  mp_size_t i = 0;
+
+  for (; i + 8 <= n; i += 8)
+    {
+      const __m512i a = _mm512_loadu_si512 (ap + i);
+      const __m512i s = _mm512_add_epi64 (a, _mm512_loadu_si512 (bp + i));
+      const unsigned g = _mm512_cmplt_epu64_mask (s, a);
+      const unsigned p = _mm512_cmpeq_epu64_mask (s, ones);
+      const unsigned c = (g << 1 | carry) + p;
+      carry = c >> 8;
+      _mm512_storeu_si512 (rp + i, _mm512_mask_sub_epi64 (s, (__mmask8) (c ^ p), s, ones));
+    }
+  return scalar_add_nc (rp + i, ap + i, bp + i, n - i, carry);
+}
+
+MINI_GMP_AVX512 static mp_limb_t
+avx512_sub_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+{
+  const __m512i ones = _mm512_set1_epi64 (-1);
+  unsigned borrow = 0;
+  mp_size_t i = 0;
+
+  for (; i + 8 <= n; i += 8)
+    {
+      const __m512i a = _mm512_loadu_si512 (ap + i);
+      const __m512i b = _mm512_loadu_si512 (bp + i);
+      const __m512i d = _mm512_sub_epi64 (a, b);
+      const unsigned g = _mm512_cmplt_epu64_mask (a, b);
+      const unsigned p = _mm512_testn_epi64_mask (d, d);
+      const unsigned c = (g << 1 | borrow) + p;
+      borrow = c >> 8;
+      _mm512_storeu_si512 (rp + i, _mm512_mask_add_epi64 (d, (__mmask8) (c ^ p), d, ones));
+    }
+  return scalar_sub_nc (rp + i, ap + i, bp + i, n - i, borrow);
+}
+
+MINI_GMP_AVX512 static void
+avx512_lshift (mp_ptr rp, mp_srcptr up, mp_size_t n, unsigned cnt)
+{
+  const __m128i l = _mm_cvtsi32_si128 ((int) cnt);
+  const __m128i r = _mm_cvtsi32_si128 ((int) (64 - cnt));
+  mp_size_t i = n;
+
+  for (; i > 8; i -= 8)
+    {
+      const __m512i hi = _mm512_loadu_si512 (up + i - 8);
+      const __m512i lo = _mm512_loadu_si512 (up + i - 9);
+      _mm512_storeu_si512 (rp + i - 8,
+			   _mm512_or_si512 (_mm512_sll_epi64 (hi, l), _mm512_srl_epi64 (lo, r)));
+    }
+  avx2_lshift (rp, up, i, cnt);
+}
+
+MINI_GMP_AVX512 static void
+avx512_rshift (mp_ptr rp, mp_srcptr up, mp_size_t n, unsigned cnt)
+{
+  const __m128i r = _mm_cvtsi32_si128 ((int) cnt);
+  const __m128i l = _mm_cvtsi32_si128 ((int) (64 - cnt));
+  mp_size_t i = 0;
+
+  for (; i + 8 < n; i += 8)
+    {
+      const __m512i lo = _mm512_loadu_si512 (up + i);
+      const __m512i hi = _mm512_loadu_si512 (up + i + 1);
+      _mm512_storeu_si512 (rp + i,
+			   _mm512_or_si512 (_mm512_srl_epi64 (lo, r), _mm512_sll_epi64 (hi, l)));
+    }
+  avx2_rshift (rp + i, up + i, n - i, cnt);
+}
+
+/* AVX-512 IFMA kernels.  vpmadd52luq / vpmadd52huq add the low / high 52
+   bits of eight 52x52-bit products to 64-bit lanes, so operands are split
+   into 52-bit digits and the lanes absorb thousands of partial products
+   before they need normalizing.  The 64 <-> 52-bit conversions are linear,
+   which pays off from MINI_GMP_DISPATCH_MUL_MIN limbs on; IFMA_MAX_LIMBS
+   bounds the stack buffers. */
+
+#define IFMA_MAX_LIMBS 64
+#define IFMA_MAX_DIGITS ((IFMA_MAX_LIMBS * 64 + 51) / 52)
+#define IFMA_VECTORS ((IFMA_MAX_DIGITS + 1 + 7) / 8)
+#define DIGIT_MASK (((mp_limb_t) 1 << 52) - 1)
+
+/* Writes the dn 52-bit digits of {up, un} << shift, shift < 52, streaming
+   the limbs through a bit buffer. */
+static void
+to_radix52 (mp_limb_t *dp, mp_size_t dn, mp_srcptr up, mp_size_t un, unsigned shift)
+{
+  mp_limb_t buf = 0;
+  unsigned bits = shift;
+  mp_size_t i, j = 0;
+
+  for (i = 0; i < dn; i++)
+    if (bits >= 52)
+      {
+	dp[i] = buf & DIGIT_MASK;
+	buf >>= 52;
+	bits -= 52;
+      }
+    else
+      {
+	const mp_limb_t x = j < un ? up[j] : 0;
+	j++;
+	dp[i] = (buf | x << bits) & DIGIT_MASK;
+	buf = x >> (52 - bits);
+	bits += 12;
+      }
+}
+
+/* Packs the normalized digits {dp, dn} into rn limbs, zero-extended. */
+static void
+from_radix52 (mp_ptr rp, mp_size_t rn, const mp_limb_t *dp, mp_size_t dn)
+{
+  mp_limb_t buf = 0;
+  unsigned bits = 0;
+  mp_size_t i, j = 0;
+
+  for (i = 0; i < rn; i++)
+    {
+      mp_limb_t l = buf;
+      for (;;)
+	{
+	  const mp_limb_t d = j < dn ? dp[j] : 0;
+	  j++;
+	  l |= d << bits;
+	  if (bits >= 12)
+	    {
+	      buf = d >> (64 - bits);
+	      bits -= 12;
+	      break;
+	    }
+	  bits += 52;
+	}
+      rp[i] = l;
+    }
+}
+
+#define MINI_GMP_IFMA __attribute__ ((target ("avx512f,avx512ifma")))
+
+/* Product scanning: each 8-digit block of the result accumulates its low
+   and high halves in registers, reading the shifted a digits with
+   unaligned loads from a zero-padded copy.  Two chains per half hide the
+   IFMA latency. */
+MINI_GMP_IFMA static void
+ifma_mul (mp_ptr rp, mp_srcptr up, mp_size_t un, mp_srcptr vp, mp_size_t vn)
+{
+  mp_limb_t a[2 * IFMA_MAX_DIGITS + 8], b[IFMA_MAX_DIGITS];
+  mp_limb_t lo[2 * IFMA_MAX_DIGITS + 8], hi[2 * IFMA_MAX_DIGITS + 8];
+  mp_limb_t d[2 * IFMA_MAX_DIGITS + 8];
+  const mp_size_t ka = (64 * un + 51) / 52, kb = (64 * vn + 51) / 52;
+  const mp_size_t blocks = (ka + kb + 7) / 8;
+  mp_limb_t *const ap = a + IFMA_MAX_DIGITS;
+  mp_limb_t carry;
+  mp_size_t o, j, i;
+
+  for (i = 1; i <= 7; i++)
+    ap[-i] = ap[ka + i - 1] = 0;
+  to_radix52 (ap, ka, up, un, 0);
+  to_radix52 (b, kb, vp, vn, 0);
+
+  for (o = 0; o < blocks; o++)
+    {
+      const mp_size_t j0 = 8 * o - ka + 1 > 0 ? 8 * o - ka + 1 : 0;
+      const mp_size_t j1 = 8 * o + 7 < kb - 1 ? 8 * o + 7 : kb - 1;
+      __m512i l0 = _mm512_setzero_si512 (), l1 = _mm512_setzero_si512 ();
+      __m512i h0 = _mm512_setzero_si512 (), h1 = _mm512_setzero_si512 ();
+
+      for (j = j0; j < j1; j += 2)
+	{
+	  const __m512i a0 = _mm512_loadu_si512 (ap + 8 * o - j);
+	  const __m512i a1 = _mm512_loadu_si512 (ap + 8 * o - j - 1);
+	  const __m512i b0 = _mm512_set1_epi64 ((long long) b[j]);
+	  const __m512i b1 = _mm512_set1_epi64 ((long long) b[j + 1]);
+	  l0 = _mm512_madd52lo_epu64 (l0, a0, b0);
+	  h0 = _mm512_madd52hi_epu64 (h0, a0, b0);
+	  l1 = _mm512_madd52lo_epu64 (l1, a1, b1);
+	  h1 = _mm512_madd52hi_epu64 (h1, a1, b1);
+	}
+      if (j == j1)
+	{
+	  const __m512i a0 = _mm512_loadu_si512 (ap + 8 * o - j);
+	  const __m512i b0 = _mm512_set1_epi64 ((long long) b[j]);
+	  l0 = _mm512_madd52lo_epu64 (l0, a0, b0);
+	  h0 = _mm512_madd52hi_epu64 (h0, a0, b0);
+	}
+      _mm512_storeu_si512 (lo + 8 * o, _mm512_add_epi64 (l0, l1));
+      _mm512_storeu_si512 (hi + 8 * o, _mm512_add_epi64 (h0, h1));
+    }
+
+  /* Digit k collects the low halves of column k and the high halves of
+     column k - 1. */
+  carry = 0;
+  for (i = 0; i < 8 * blocks; i++)
+    {
+      const mp_limb_t t = lo[i] + (i > 0 ? hi[i - 1] : 0) + carry;
+      d[i] = t & DIGIT_MASK;
+      carry = t >> 52;
+    }
+  from_radix52 (rp, un + vn, d, 8 * blocks);
+}
+
+/* Almost-Montgomery multiplication in radix 2^52 with k digits.  The
+   accumulator stays in registers; each step adds a * b[i] and q * m, where
+   q clears the low digit, then shifts one lane down.  With R = 2^(52k),
+   pre-shifting a by s = 52k - 64n bits makes the result a * b / 2^(64n),
+   as for the scalar code.  a * 2^s < R, so the result is below 2m and
+   needs at most one subtraction. */
+MINI_GMP_IFMA static void
+ifma_montmul (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_srcptr mp, mp_size_t n,
+	      mp_limb_t minv)
+{
+  mp_limb_t a[8 * IFMA_VECTORS], m[8 * IFMA_VECTORS], b[IFMA_MAX_DIGITS];
+  mp_limb_t d[8 * IFMA_VECTORS], r[IFMA_MAX_LIMBS + 1];
+  __m512i av[IFMA_VECTORS], mv[IFMA_VECTORS], acc[IFMA_VECTORS];
+  const mp_size_t k = (64 * n + 51) / 52;
+  const mp_size_t vectors = (k + 1 + 7) / 8;
+  const unsigned shift = (unsigned) (52 * k - 64 * n);
+  const mp_limb_t q_inv = minv & DIGIT_MASK;
+  mp_limb_t carry;
+  mp_size_t i, v;
+
+  to_radix52 (a, 8 * vectors, ap, n, shift);
+  to_radix52 (m, 8 * vectors, mp, n, 0);
+  to_radix52 (b, k, bp, n, 0);
+  for (v = 0; v < vectors; v++)
+    {
+      av[v] = _mm512_loadu_si512 (a + 8 * v);
+      mv[v] = _mm512_loadu_si512 (m + 8 * v);
+      acc[v] = _mm512_setzero_si512 ();
+    }
+
+  for (i = 0; i < k; i++)
+    {
+      const __m512i bi = _mm512_set1_epi64 ((long long) b[i]);
+      __m512i qv;
+      mp_limb_t q;
+
+      for (v = 0; v < vectors; v++)
+	acc[v] = _mm512_madd52lo_epu64 (acc[v], av[v], bi);
+      q = ((mp_limb_t) _mm_cvtsi128_si64 (_mm512_castsi512_si128 (acc[0])) * q_inv) & DIGIT_MASK;
+      qv = _mm512_set1_epi64 ((long long) q);
+      for (v = 0; v < vectors; v++)
+	acc[v] = _mm512_madd52lo_epu64 (acc[v], mv[v], qv);
+
+      /* The low digit is now a multiple of 2^52: shift it out, keeping its
+	 carry, then add the high halves one digit lower. */
+      carry = (mp_limb_t) _mm_cvtsi128_si64 (_mm512_castsi512_si128 (acc[0])) >> 52;
+      for (v = 0; v + 1 < vectors; v++)
+	acc[v] = _mm512_alignr_epi64 (acc[v + 1], acc[v], 1);
+      acc[v] = _mm512_alignr_epi64 (_mm512_setzero_si512 (), acc[v], 1);
+      acc[0] = _mm512_add_epi64 (acc[0], _mm512_maskz_set1_epi64 (1, (long long) carry));
+      for (v = 0; v < vectors; v++)
+	{
+	  acc[v] = _mm512_madd52hi_epu64 (acc[v], av[v], bi);
+	  acc[v] = _mm512_madd52hi_epu64 (acc[v], mv[v], qv);
+	}
+    }
+
+  for (v = 0; v < vectors; v++)
+    _mm512_storeu_si512 (d + 8 * v, acc[v]);
+  carry = 0;
+  for (i = 0; i <= k; i++)
+    {
+      const mp_limb_t t = d[i] + carry;
+      d[i] = t & DIGIT_MASK;
+      carry = t >> 52;
+    }
+  from_radix52 (r, n + 1, d, k + 1);
+  if (r[n] != 0 || mpn_cmp (r, mp, n) >= 0)
+    mpn_sub_n (r, r, mp, n);
+  mpn_copyi (rp, r, n);
+}
+
+#define MINI_GMP_AVX512_KERNELS(popcount, hamdist, mul, montmul)		\
+  { "avx512", popcount, hamdist, avx512_and_n, avx512_ior_n, avx512_xor_n, \
+    avx512_com, avx512_zero_p, avx512_mul_1_batch, avx512_addmul_1_batch, \
+    avx512_add_n, avx512_sub_n, avx512_lshift, avx512_rshift, mul, montmul }
+
+/* Indexed by VPOPCNTDQ | IFMA << 1; without VPOPCNTDQ the popcounts stay on
+   the AVX2 kernels. */
+static const struct mini_gmp_kernels kernels_avx512[4] = {
+  MINI_GMP_AVX512_KERNELS (avx2_popcount, avx2_hamdist, NULL, NULL),
+  MINI_GMP_AVX512_KERNELS (avx512_popcount, avx512_hamdist, NULL, NULL),
+  MINI_GMP_AVX512_KERNELS (avx2_popcount, avx2_hamdist, ifma_mul, ifma_montmul),
+  MINI_GMP_AVX512_KERNELS (avx512_popcount, avx512_hamdist, ifma_mul, ifma_montmul)
+};
+
+#endif /* MINI_GMP_X86_DISPATCH */
+
+
+/* Level selection */
+
+/* Levels by increasing preference; NULL where unavailable in this build or
+   on this CPU. */
+enum { LEVEL_SCALAR, LEVEL_XSIMD, LEVEL_AVX2, LEVEL_AVX512, LEVEL_COUNT };
+
+static const char *const level_names[LEVEL_COUNT] = { "scalar", "xsimd", "avx2", "avx512" };
+
+static const struct mini_gmp_kernels *
+level_kernels (int level)
+{
+  switch (level)
+    {
+    case LEVEL_SCALAR:
+      return &kernels_scalar;
+#ifdef MINI_GMP_SIMD
+    case LEVEL_XSIMD:
+      return &kernels_xsimd;
+#endif
+#if MINI_GMP_X86_DISPATCH
+    case LEVEL_AVX2:
+      __builtin_cpu_init ();
+      return __builtin_cpu_supports ("avx2") ? &kernels_avx2 : NULL;
+    case LEVEL_AVX512:
+      __builtin_cpu_init ();
+      if (!__builtin_cpu_supports ("avx512f") || !__builtin_cpu_supports ("avx2"))
+	return NULL;
+      return &kernels_avx512[(__builtin_cpu_supports ("avx512vpopcntdq") ? 1 : 0)
+			     | (__builtin_cpu_supports ("avx512ifma") ? 2 : 0)];
+#endif
+    default:
+      return NULL;
+    }
+}
+
+static int
+level_index (const char *name)
+{
+  int level;
+  for (level = 0; level < LEVEL_COUNT; level++)
+    if (strcmp (name, level_names[level]) == 0)
+      return level;
+  return -1;
+}
+
+/* Best available level not above max_level. */
+static const struct mini_gmp_kernels *
+select_kernels (int max_level)
+{
+  int level;
+  for (level = max_level; level > LEVEL_SCALAR; level--)
+    {
+      const struct mini_gmp_kernels *k = level_kernels (level);
+      if (k != NULL)
+	return k;
+    }
+  return &kernels_scalar;
+}
+
+static const struct mini_gmp_kernels *active_kernels = NULL;
+
+static const struct mini_gmp_kernels *
+kernels (void)
+{
+  const struct mini_gmp_kernels *k = MINI_GMP_LOAD_PTR (active_kernels);
+  if (k == NULL)
+    {
+      const char *env = getenv ("MINI_GMP_SIMD_LEVEL");
+      const int max_level = env != NULL ? level_index (env) : -1;
+      k = select_kernels (max_level >= 0 ? max_level : LEVEL_COUNT - 1);
+      MINI_GMP_STORE_PTR (active_kernels, k);
+    }
+  return k;
+}
+
+const char *
+mini_gmp_simd_level (void)
+{
+  return kernels ()->name;
+}
+
+int
+mini_gmp_set_simd_level (const char *name)
+{
+  const int level = level_index (name);
+  const struct mini_gmp_kernels *k;
+  if (level < 0)
+    return -1;
+  k = select_kernels (level);
+  MINI_GMP_STORE_PTR (active_kernels, k);
+  return strcmp (k->name, name) == 0;
+}
+
+
+/* Public entry points */
+
+mp_bitcnt_t
+mpn_popcount (mp_srcptr p, mp_size_t n)
+{
+  if (n < MINI_GMP_DISPATCH_THRESHOLD)
+    return scalar_popcount (p, n);
+  return kernels ()->popcount (p, n);
+}
+
+mp_bitcnt_t
+mpn_hamdist (mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+{
+  if (n < MINI_GMP_DISPATCH_THRESHOLD)
+    return scalar_hamdist (ap, bp, n);
+  return kernels ()->hamdist (ap, bp, n);
+}
+
+void
+mpn_and_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+{
+  if (n < MINI_GMP_DISPATCH_THRESHOLD)
+    scalar_and_n (rp, ap, bp, n);
+  else
+    kernels ()->and_n (rp, ap, bp, n);
+}
+
+void
+mpn_ior_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+{
+  if (n < MINI_GMP_DISPATCH_THRESHOLD)
+    scalar_ior_n (rp, ap, bp, n);
+  else
+    kernels ()->ior_n (rp, ap, bp, n);
+}
+
+void
+mpn_xor_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+{
+  if (n < MINI_GMP_DISPATCH_THRESHOLD)
+    scalar_xor_n (rp, ap, bp, n);
+  else
+    kernels ()->xor_n (rp, ap, bp, n);
+}
+
+void
+mpn_com (mp_ptr rp, mp_srcptr up, mp_size_t n)
+{
+  if (n < MINI_GMP_DISPATCH_THRESHOLD)
+    scalar_com (rp, up, n);
+  else
+    kernels ()->com (rp, up, n);
+}
+
+int
+mpn_zero_p (mp_srcptr rp, mp_size_t n)
+{
+  if (n < MINI_GMP_DISPATCH_THRESHOLD)
+    return scalar_zero_p (rp, n);
+  return kernels ()->zero_p (rp, n);
+}
+
+void
+mpn_mul_1_batch (mp_ptr rp, mp_srcptr up, mp_size_t n, mp_srcptr vp,
+		 mp_ptr cp, mp_size_t count)
+{
+  assert (n >= 1);
+  assert (count >= 0);
+  kernels ()->mul_1_batch (rp, up, n, vp, cp, count);
+}
+
+void
+mpn_addmul_1_batch (mp_ptr rp, mp_srcptr up, mp_size_t n, mp_srcptr vp,
+		    mp_ptr cp, mp_size_t count)
+{
+  assert (n >= 1);
+  assert (count >= 0);
+  kernels ()->addmul_1_batch (rp, up, n, vp, cp, count);
+}
+
+int
+mini_gmp_dispatch_mul (mp_ptr rp, mp_srcptr up, mp_size_t un, mp_srcptr vp, mp_size_t vn)
+{
+#if MINI_GMP_X86_DISPATCH
+  if (vn >= MINI_GMP_DISPATCH_MUL_MIN && un <= IFMA_MAX_LIMBS)
+    {
+      const struct mini_gmp_kernels *k = kernels ();
+      if (k->mul != NULL)
+	{
+	  k->mul (rp, up, un, vp, vn);
+	  return 1;
+	}
+    }
+#endif
+  return 0;
+}
+
+int
+mini_gmp_dispatch_montmul (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_srcptr mp,
+			   mp_size_t n, mp_limb_t minv)
+{
+#if MINI_GMP_X86_DISPATCH
+  if (n >= MINI_GMP_DISPATCH_MUL_MIN && n <= IFMA_MAX_LIMBS)
+    {
+      const struct mini_gmp_kernels *k = kernels ();
+      if (k->montmul != NULL)
+	{
+	  k->montmul (rp, ap, bp, mp, n, minv);
+	  return 1;
+	}
+    }
+#endif
+  return 0;
+}
+
+int
+mini_gmp_dispatch_add_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+{
+  const struct mini_gmp_kernels *k;
+  if (n < MINI_GMP_DISPATCH_ADD_MIN)
+    return -1;
+  k = kernels ();
+  return k->add_n != NULL ? (int) k->add_n (rp, ap, bp, n) : -1;
+}
+
+int
+mini_gmp_dispatch_sub_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+{
+  const struct mini_gmp_kernels *k;
+  if (n < MINI_GMP_DISPATCH_ADD_MIN)
+    return -1;
+  k = kernels ();
+  return k->sub_n != NULL ? (int) k->sub_n (rp, ap, bp, n) : -1;
+}
+
+int
+mini_gmp_dispatch_lshift (mp_ptr rp, mp_srcptr up, mp_size_t n, unsigned cnt)
+{
+  const struct mini_gmp_kernels *k;
+  if (n < MINI_GMP_DISPATCH_SHIFT_MIN)
+    return 0;
+  k = kernels ();
+  if (k->lshift == NULL)
+    return 0;
+  k->lshift (rp, up, n, cnt);
+  return 1;
+}
+
+int
+mini_gmp_dispatch_rshift (mp_ptr rp, mp_srcptr up, mp_size_t n, unsigned cnt)
+{
+  const struct mini_gmp_kernels *k;
+  if (n < MINI_GMP_DISPATCH_SHIFT_MIN)
+    return 0;
+  k = kernels ();
+  if (k->rshift == NULL)
+    return 0;
+  k->rshift (rp, up, n, cnt);
+  return 1;
+}
@@ -0,0 +1,43 @@
+/* mini-gmp-dispatch.h — private interface between the mpn code of
+   mini-gmp.c / mini-gmp-simd.cpp and the run-time selected kernels of
+   mini-gmp-dispatch.c.  Not installed.
+
+   The callers test the size thresholds inline, so short operands stay on
+   the scalar loops without a call; the hooks check them again and return
+   -1 (add_n / sub_n) or 0 (mul / montmul / lshift / rshift) when they have
+   nothing for the operands. */
+
+#ifndef MINI_GMP_DISPATCH_H
+#define MINI_GMP_DISPATCH_H
+
+#include "mini-gmp.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+/* Below this size the adc chain beats the carry-save kernels. */
+#define MINI_GMP_DISPATCH_ADD_MIN 8
+
+int mini_gmp_dispatch_add_n (mp_ptr, mp_srcptr, mp_srcptr, mp_size_t);
+int mini_gmp_dispatch_sub_n (mp_ptr, mp_srcptr, mp_srcptr, mp_size_t);
+
+/* Likewise for the shift kernels against the scalar shift loops. */
+#define MINI_GMP_DISPATCH_SHIFT_MIN 6
+
+int mini_gmp_dispatch_lshift (mp_ptr, mp_srcptr, mp_size_t, unsigned);
+int mini_gmp_dispatch_rshift (mp_ptr, mp_srcptr, mp_size_t, unsigned);
+
+/* The AVX-512 IFMA product and Montgomery kernels convert to radix 2^52 in
+   linear time, which pays off from this size on; below it the small
+   products of the geometric predicates skip the call. */
+#define MINI_GMP_DISPATCH_MUL_MIN 12
+
+int mini_gmp_dispatch_mul (mp_ptr, mp_srcptr, mp_size_t, mp_srcptr, mp_size_t);
+int mini_gmp_dispatch_montmul (mp_ptr, mp_srcptr, mp_srcptr, mp_srcptr, mp_size_t, mp_limb_t);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* MINI_GMP_DISPATCH_H */
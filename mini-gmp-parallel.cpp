@@ -0,0 +1,294 @@
+/* mini-gmp-parallel.cpp — the work-stealing task pool behind the parallel
+ * operations of mini-gmp.c (mpn_mul_threads, mpz_mul_threads, and mpn_mul
+ * / mpz_mul on huge operands when mini_gmp_set_threads allows it).
+ *
+ * Each worker owns a deque: it pushes and pops forked tasks at the back
+ * (depth first, cache-warm) and idle workers steal from the front of the
+ * others' (the oldest, largest subproblems).  Threads outside the pool
+ * post to a shared inbox.  A thread joining a task keeps running queued
+ * tasks until it completes, so fork-join recursion never blocks a worker
+ * while there is work; with none left, it sleeps until the task is done
+ * rather than spin on a busy host.
+ *
+ * The pool is created on first use and grows up to the largest thread
+ * count requested; the workers sleep when there is nothing to do.  Each
+ * parallel call carries its own budget of threads (struct mini_gmp_par):
+ * a fork only becomes a task while the budget has a spare thread, which
+ * bounds the concurrency of that call whatever the pool size.
+ *
+ * A task runs with the thread-local memory functions of the thread that
+ * forked it, so that the limbs it allocates for the caller's numbers come
+ * from, and go back to, the caller's allocator.
+ *
+ * The arithmetic stays in mini-gmp.c; this file only schedules
+ * void (*) (void *) callbacks.
+ */
+
+#include "mini-gmp.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+struct mini_gmp_par
+{
+    std::atomic<int> spare;
+};
+
+namespace {
+
+const int kMaxWorkers = 256;
+
+/* Rounds of looking for other work, yielding in between, before a join
+   whose task runs elsewhere blocks until it completes. */
+const int kJoinSpins = 64;
+
+/* The memory functions of mp_set_thread_memory_functions. */
+struct MemoryFunctions
+{
+    void *(*alloc)(size_t);
+    void *(*realloc)(void *, size_t, size_t);
+    void (*free)(void *, size_t);
+
+    void get() { mp_get_thread_memory_functions(&alloc, &realloc, &free); }
+    void set() const { mp_set_thread_memory_functions(alloc, realloc, free); }
+};
+
+struct Task
+{
+    void (*fn)(void *);
+    void *arg;
+    /* Those of the forking thread, which may reallocate or free what the
+       task allocates. */
+    MemoryFunctions memory;
+    std::atomic<bool> done;
+};
+
+struct TaskQueue
+{
+    std::mutex mutex;
+    std::deque<Task *> tasks;
+
+    void push_back(Task *t)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(t);
+    }
+
+    Task *pop_back()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty())
+            return nullptr;
+        Task *t = tasks.back();
+        tasks.pop_back();
+        return t;
+    }
+
+    Task *pop_front()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty())
+            return nullptr;
+        Task *t = tasks.front();
+        tasks.pop_front();
+        return t;
+    }
+};
+
+/* Index of the calling thread's deque, -1 outside the pool. */
+thread_local int tls_worker = -1;
+
+class Pool
+{
+public:
+    /* Makes sure at least n workers run. */
+    void reserve(int n)
+    {
+        if (n > kMaxWorkers)
+            n = kMaxWorkers;
+        if (started_.load(std::memory_order_acquire) >= n)
+            return;
+        std::lock_guard<std::mutex> lock(grow_mutex_);
+        for (int i = started_.load(std::memory_order_relaxed); i < n; ++i) {
+            std::thread(&Pool::worker_main, this, i).detach();
+            started_.store(i + 1, std::memory_order_release);
+        }
+    }
+
+    void push(Task *t)
+    {
+        if (tls_worker >= 0)
+            queues_[tls_worker].push_back(t);
+        else
+            inbox_.push_back(t);
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            pending_.fetch_add(1, std::memory_order_relaxed);
+        }
+        sleep_cv_.notify_one();
+    }
+
+    /* Runs t's function or, while someone else does, other queued tasks;
+       once there are none for a while, sleeps until t is done. */
+    void join(Task *t)
+    {
+        int idle = 0;
+        while (!t->done.load(std::memory_order_acquire)) {
+            if (run_one()) {
+                idle = 0;
+                continue;
+            }
+            if (++idle < kJoinSpins) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(join_mutex_);
+            joiners_.fetch_add(1, std::memory_order_seq_cst);
+            join_cv_.wait(lock, [t] { return t->done.load(std::memory_order_seq_cst); });
+            joiners_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    Task *take()
+    {
+        Task *t = nullptr;
+        if (tls_worker >= 0)
+            t = queues_[tls_worker].pop_back();
+        if (t == nullptr)
+            t = inbox_.pop_front();
+        if (t == nullptr) {
+            const int n = started_.load(std::memory_order_acquire);
+            const int first = tls_worker >= 0 ? tls_worker + 1 : 0;
+            for (int i = 0; i < n && t == nullptr; ++i)
+                t = queues_[(first + i) % n].pop_front();
+        }
+        return t;
+    }
+
+    bool run_one()
+    {
+        Task *t = take();
+        if (t == nullptr)
+            return false;
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        MemoryFunctions own;
+        own.get();
+        t->memory.set();
+        t->fn(t->arg);
+        own.set();
+        /* The owner may return and free t as soon as this is seen; the
+           pool's join_mutex_ and join_cv_ outlive it. */
+        t->done.store(true, std::memory_order_seq_cst);
+        if (joiners_.load(std::memory_order_seq_cst) > 0) {
+            { std::lock_guard<std::mutex> lock(join_mutex_); }
+            join_cv_.notify_all();
+        }
+        return true;
+    }
+
+    void worker_main(int self)
+    {
+        tls_worker = self;
+        for (;;) {
+            if (run_one())
+                continue;
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            sleep_cv_.wait(lock, [this] { return pending_.load(std::memory_order_relaxed) > 0; });
+        }
+    }
+
+    TaskQueue queues_[kMaxWorkers];
+    TaskQueue inbox_;
+    std::atomic<int> started_{0};
+    std::mutex grow_mutex_;
+    std::atomic<long> pending_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    std::atomic<int> joiners_{0};
+    std::mutex join_mutex_;
+    std::condition_variable join_cv_;
+};
+
+/* Never destroyed: detached workers may still be asleep on it at exit. */
+Pool &pool()
+{
+    static Pool *p = new Pool;
+    return *p;
+}
+
+/* 0 until read from MINI_GMP_THREADS on first use. */
+std::atomic<int> threads_limit{0};
+
+} // anonymous namespace
+
+extern "C" {
+
+int mini_gmp_threads(void)
+{
+    int n = threads_limit.load(std::memory_order_acquire);
+    if (n == 0) {
+        const char *env = std::getenv("MINI_GMP_THREADS");
+        n = env != nullptr ? std::atoi(env) : 1;
+        if (n < 1)
+            n = 1;
+        threads_limit.store(n, std::memory_order_release);
+    }
+    return n;
+}
+
+void mini_gmp_set_threads(int n)
+{
+    threads_limit.store(n < 1 ? 1 : n, std::memory_order_release);
+}
+
+/* A budget of `threads` threads, the caller included; NULL (serial) for
+   one thread. */
+struct mini_gmp_par *mini_gmp_par_begin(int threads)
+{
+    if (threads <= 1)
+        return nullptr;
+    if (threads > kMaxWorkers + 1)
+        threads = kMaxWorkers + 1;
+    pool().reserve(threads - 1);
+    mini_gmp_par *par = new mini_gmp_par;
+    par->spare.store(threads - 1, std::memory_order_relaxed);
+    return par;
+}
+
+void mini_gmp_par_end(struct mini_gmp_par *par)
+{
+    delete par;
+}
+
+/* f (a) and g (b), g as a task when the budget has a spare thread; returns
+   once both are done. */
+void mini_gmp_par_do2(struct mini_gmp_par *par, void (*f)(void *), void *a,
+                      void (*g)(void *), void *b)
+{
+    if (par == nullptr || par->spare.fetch_sub(1, std::memory_order_acq_rel) <= 0) {
+        if (par != nullptr)
+            par->spare.fetch_add(1, std::memory_order_relaxed);
+        f(a);
+        g(b);
+        return;
+    }
+
+    Task task;
+    task.fn = g;
+    task.arg = b;
+    task.memory.get();
+    task.done.store(false, std::memory_order_relaxed);
+    pool().push(&task);
+    f(a);
+    /* Unless stolen meanwhile, the task is still at the back of this
+       thread's deque and join runs it here. */
+    pool().join(&task);
+    par->spare.fetch_add(1, std::memory_order_release);
+}
+
+} // extern "C"
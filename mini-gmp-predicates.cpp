@@ -0,0 +1,96 @@
+/* mini-gmp-predicates.cpp — batched filter stage of the geometric predicates
+ * declared in MiniMPFPredicates.hpp.
+ *
+ * With MINI_GMP_SIMD (MINI_GMP_ENABLE_SIMD=ON) the orient3d filter runs
+ * across xsimd::batch<double> lanes, using the same expression and error
+ * bound as the scalar orient3d_filter; remaining entries and non-SIMD builds
+ * use the scalar filter.  Both only ever report signs that are certain, so
+ * they may differ only in which entries they leave uncertain.
+ */
+
+#include "MiniMPFPredicates.hpp"
+
+#ifdef MINI_GMP_SIMD
+#include <xsimd/xsimd.hpp>
+#endif
+
+namespace mini_gmp_plus_predicates {
+
+namespace {
+
+inline std::size_t orient3d_filter_scalar(const Orient3dBatch& in, std::size_t i, std::size_t end,
+                                          int* signs, std::size_t* uncertain, std::size_t n)
+{
+    for (; i < end; ++i) {
+        const double pa[3] = { in.ax[i], in.ay[i], in.az[i] };
+        const double pb[3] = { in.bx[i], in.by[i], in.bz[i] };
+        const double pc[3] = { in.cx[i], in.cy[i], in.cz[i] };
+        const double pd[3] = { in.dx[i], in.dy[i], in.dz[i] };
+        int sign = 0;
+        if (!orient3d_filter(pa, pb, pc, pd, sign)) {
+            uncertain[n++] = i;
+        }
+        signs[i] = sign;
+    }
+    return n;
+}
+
+} // anonymous namespace
+
+std::size_t orient3d_filter_batch(const Orient3dBatch& in, int* signs, std::size_t* uncertain)
+{
+    std::size_t i = 0;
+    std::size_t n = 0;
+
+#ifdef MINI_GMP_SIMD
+    using dbatch = xsimd::batch<double>;
+    constexpr std::size_t DW = dbatch::size;
+
+    const dbatch bound(detail::o3derrboundA);
+    const dbatch one(1.0);
+    const dbatch zero(0.0);
+    for (; i + DW <= in.count; i += DW) {
+        const dbatch dx = dbatch::load_unaligned(in.dx + i);
+        const dbatch dy = dbatch::load_unaligned(in.dy + i);
+        const dbatch dz = dbatch::load_unaligned(in.dz + i);
+        const dbatch adx = dbatch::load_unaligned(in.ax + i) - dx;
+        const dbatch ady = dbatch::load_unaligned(in.ay + i) - dy;
+        const dbatch adz = dbatch::load_unaligned(in.az + i) - dz;
+        const dbatch bdx = dbatch::load_unaligned(in.bx + i) - dx;
+        const dbatch bdy = dbatch::load_unaligned(in.by + i) - dy;
+        const dbatch bdz = dbatch::load_unaligned(in.bz + i) - dz;
+        const dbatch cdx = dbatch::load_unaligned(in.cx + i) - dx;
+        const dbatch cdy = dbatch::load_unaligned(in.cy + i) - dy;
+        const dbatch cdz = dbatch::load_unaligned(in.cz + i) - dz;
+
+        const dbatch bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+        const dbatch cdxady = cdx * ady, adxcdy = adx * cdy;
+        const dbatch adxbdy = adx * bdy, bdxady = bdx * ady;
+
+        const dbatch det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+        const dbatch permanent = (xsimd::abs(bdxcdy) + xsimd::abs(cdxbdy)) * xsimd::abs(adz)
+                               + (xsimd::abs(cdxady) + xsimd::abs(adxcdy)) * xsimd::abs(bdz)
+                               + (xsimd::abs(adxbdy) + xsimd::abs(bdxady)) * xsimd::abs(cdz);
+        const dbatch errbound = bound * permanent;
+
+        /* +1 / -1 where certain, 0 where the filter fails (including NaN). */
+        const dbatch s = xsimd::select(det > errbound, one,
+                                       xsimd::select(-det > errbound, -one, zero));
+        if (xsimd::all(s != zero)) {
+            for (std::size_t l = 0; l < DW; ++l)
+                signs[i + l] = static_cast<int>(s.get(l));
+            continue;
+        }
+        for (std::size_t l = 0; l < DW; ++l) {
+            const int sign = static_cast<int>(s.get(l));
+            if (sign == 0)
+                uncertain[n++] = i + l;
+            signs[i + l] = sign;
+        }
+    }
+#endif
+
+    return orient3d_filter_scalar(in, i, in.count, signs, uncertain, n);
+}
+
+} // namespace mini_gmp_plus_predicates
@@ -3,12 +3,18 @@
  * Compiled only when MINI_GMP_ENABLE_SIMD=ON (defines MINI_GMP_SIMD).
  * Requires xsimd ≥ 14 and C++17.
  *
+ * The mini_gmp_xsimd_* kernels are not called directly: they form the
+ * "xsimd" level of the runtime dispatch table in mini-gmp-dispatch.c,
+ * which owns the public mpn_popcount, mpn_hamdist, mpn_and_n, mpn_ior_n,
+ * mpn_xor_n, mpn_com and mpn_zero_p.
+ *
  * xsimd 14 element-access API used here:
  *   batch.get(i)      — extract element at runtime index i → T
  *   batch_bool.get(i) — extract element at runtime index i → bool
  */
 
 #include "mini-gmp.h"
+#include "mini-gmp-dispatch.h"
 #include <xsimd/xsimd.hpp>
 #include <climits>   /* CHAR_BIT */
 #include <cassert>
@@ -210,7 +216,7 @@ void mpn_zero(mp_ptr rp, mp_size_t n)
 
 /* ── bitwise complement ─────────────────────────────────────────────────── */
 
-void mpn_com(mp_ptr rp, mp_srcptr up, mp_size_t n)
+void mini_gmp_xsimd_com(mp_ptr rp, mp_srcptr up, mp_size_t n)
 {
     const batch_t ones = batch_t(~uint64_t(0));
     mp_size_t i = 0;
@@ -227,28 +233,58 @@ int mpn_cmp(mp_srcptr ap, mp_srcptr bp, mp_size_t n)
     return scalar_mpn_cmp(ap, bp, n);
 }
 
-/* ── addition with carry (scalar fallback) ──────────────────────────────── */
+/* ── addition with carry ────────────────────────────────────────────────── *
+ *
+ * One carry chain per number does not vectorise lane-wise; long operands
+ * go to the carry-save kernels of mini-gmp-dispatch.c (-1: none for this
+ * size or CPU), the rest stays on the scalar adc chain.
+ */
 mp_limb_t mpn_add_n(mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
 {
+    if (n >= MINI_GMP_DISPATCH_ADD_MIN) {
+        const int cy = mini_gmp_dispatch_add_n(rp, ap, bp, n);
+        if (cy >= 0)
+            return static_cast<mp_limb_t>(cy);
+    }
     return scalar_mpn_add_n(rp, ap, bp, n);
 }
 
-/* ── subtraction with borrow (scalar fallback) ──────────────────────────── */
+/* ── subtraction with borrow (same split as mpn_add_n) ──────────────────── */
 
 mp_limb_t mpn_sub_n(mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
 {
+    if (n >= MINI_GMP_DISPATCH_ADD_MIN) {
+        const int cy = mini_gmp_dispatch_sub_n(rp, ap, bp, n);
+        if (cy >= 0)
+            return static_cast<mp_limb_t>(cy);
+    }
     return scalar_mpn_sub_n(rp, ap, bp, n);
 }
 
-/* ── left shift (scalar fallback, overlap-safe like upstream) ───────────── */
+/* ── shifts ──────────────────────────────────────────────────────────────── *
+ *
+ * From MINI_GMP_DISPATCH_SHIFT_MIN limbs on, the AVX2 / AVX-512 shift kernels
+ * of mini-gmp-dispatch.c (0: none for this size or CPU); they keep the
+ * upstream overlap rules.
+ * The limb shifted out is read first, as an in-place shift clobbers it.
+ */
 mp_limb_t mpn_lshift(mp_ptr rp, mp_srcptr up, mp_size_t n, unsigned int cnt)
 {
+    if (n >= MINI_GMP_DISPATCH_SHIFT_MIN) {
+        const mp_limb_t retval = up[n - 1] >> (GMP_LIMB_BITS - cnt);
+        if (mini_gmp_dispatch_lshift(rp, up, n, cnt))
+            return retval;
+    }
     return scalar_mpn_lshift(rp, up, n, cnt);
 }
 
-/* ── right shift (scalar fallback, overlap-safe like upstream) ──────────── */
 mp_limb_t mpn_rshift(mp_ptr rp, mp_srcptr up, mp_size_t n, unsigned int cnt)
 {
+    if (n >= MINI_GMP_DISPATCH_SHIFT_MIN) {
+        const mp_limb_t retval = up[0] << (GMP_LIMB_BITS - cnt);
+        if (mini_gmp_dispatch_rshift(rp, up, n, cnt))
+            return retval;
+    }
     return scalar_mpn_rshift(rp, up, n, cnt);
 }
 
@@ -259,7 +295,7 @@ mp_limb_t mpn_rshift(mp_ptr rp, mp_srcptr up, mp_size_t n, unsigned int cnt)
  * which is much faster than the scalar 16-bit nibble approach in
  * gmp_popcount_limb.
  */
-mp_bitcnt_t mpn_popcount(mp_srcptr p, mp_size_t n)
+mp_bitcnt_t mini_gmp_xsimd_popcount(mp_srcptr p, mp_size_t n)
 {
     mp_size_t i = 0;
     batch_t acc = batch_t(uint64_t(0));
@@ -288,7 +324,7 @@ mp_bitcnt_t mpn_popcount(mp_srcptr p, mp_size_t n)
 
 /* ── Hamming distance (XOR + popcount in one pass) ──────────────────────── */
 
-mp_bitcnt_t mpn_hamdist(mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+mp_bitcnt_t mini_gmp_xsimd_hamdist(mp_srcptr ap, mp_srcptr bp, mp_size_t n)
 {
     mp_size_t i = 0;
     batch_t acc = batch_t(uint64_t(0));
@@ -318,7 +354,7 @@ mp_bitcnt_t mpn_hamdist(mp_srcptr ap, mp_srcptr bp, mp_size_t n)
 
 /* ── bulk logical operations (embarrassingly parallel) ──────────────────── */
 
-void mpn_and_n(mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+void mini_gmp_xsimd_and_n(mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
 {
     mp_size_t i = 0;
     for (; i + static_cast<mp_size_t>(W) <= n; i += static_cast<mp_size_t>(W))
@@ -328,7 +364,7 @@ void mpn_and_n(mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
         rp[i] = ap[i] & bp[i];
 }
 
-void mpn_ior_n(mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+void mini_gmp_xsimd_ior_n(mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
 {
     mp_size_t i = 0;
     for (; i + static_cast<mp_size_t>(W) <= n; i += static_cast<mp_size_t>(W))
@@ -338,7 +374,7 @@ void mpn_ior_n(mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
         rp[i] = ap[i] | bp[i];
 }
 
-void mpn_xor_n(mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+void mini_gmp_xsimd_xor_n(mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
 {
     mp_size_t i = 0;
     for (; i + static_cast<mp_size_t>(W) <= n; i += static_cast<mp_size_t>(W))
@@ -353,7 +389,7 @@ void mpn_xor_n(mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
  * Scan MSB→LSB: high limbs are most likely non-zero in normalised numbers,
  * so we reject early.  Uses batch OR to detect any non-zero lane.
  */
-int mpn_zero_p(mp_srcptr rp, mp_size_t n)
+int mini_gmp_xsimd_zero_p(mp_srcptr rp, mp_size_t n)
 {
     mp_size_t i = n;
     const batch_t zero = batch_t(uint64_t(0));
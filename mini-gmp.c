@@ -50,6 +50,7 @@ see https://www.gnu.org/licenses/.  */
 #include <string.h>
 
 #include "mini-gmp.h"
+#include "mini-gmp-dispatch.h"
 #include "bitops64.h" /* [Bruno Levy] 11/04/2025 intrinsics
 			 for faster 64 bits operations (Linux/MacOS/Windows) */
 
@@ -338,19 +339,41 @@ static void * (*gmp_allocate_func) (size_t) = gmp_default_alloc;
 static void * (*gmp_reallocate_func) (void *, size_t, size_t) = gmp_default_realloc;
 static void (*gmp_free_func) (void *, size_t) = gmp_default_free;
 
+/* The calling thread's overrides of the functions above, NULL where it
+   uses the global one.  The task pool runs each task with the overrides
+   of the thread that forked it. */
+#if defined(_MSC_VER)
+#  define MINI_GMP_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__) || defined(__clang__)
+#  define MINI_GMP_THREAD_LOCAL __thread
+#else
+#  define MINI_GMP_THREAD_LOCAL _Thread_local
+#endif
+
+static MINI_GMP_THREAD_LOCAL void * (*gmp_thread_allocate_func) (size_t);
+static MINI_GMP_THREAD_LOCAL void * (*gmp_thread_reallocate_func) (void *, size_t, size_t);
+static MINI_GMP_THREAD_LOCAL void (*gmp_thread_free_func) (void *, size_t);
+
+#define gmp_current_allocate_func \
+  (gmp_thread_allocate_func ? gmp_thread_allocate_func : gmp_allocate_func)
+#define gmp_current_reallocate_func \
+  (gmp_thread_reallocate_func ? gmp_thread_reallocate_func : gmp_reallocate_func)
+#define gmp_current_free_func \
+  (gmp_thread_free_func ? gmp_thread_free_func : gmp_free_func)
+
 void
 mp_get_memory_functions (void *(**alloc_func) (size_t),
 			 void *(**realloc_func) (void *, size_t, size_t),
 			 void (**free_func) (void *, size_t))
 {
   if (alloc_func)
-    *alloc_func = gmp_allocate_func;
+    *alloc_func = gmp_current_allocate_func;
 
   if (realloc_func)
-    *realloc_func = gmp_reallocate_func;
+    *realloc_func = gmp_current_reallocate_func;
 
   if (free_func)
-    *free_func = gmp_free_func;
+    *free_func = gmp_current_free_func;
 }
 
 void
@@ -370,9 +393,34 @@ mp_set_memory_functions (void *(*alloc_func) (size_t),
   gmp_free_func = free_func;
 }
 
-#define gmp_alloc(size) ((*gmp_allocate_func)((size)))
-#define gmp_free(p, size) ((*gmp_free_func) ((p), (size)))
-#define gmp_realloc(ptr, old_size, size) ((*gmp_reallocate_func)(ptr, old_size, size))
+void
+mp_get_thread_memory_functions (void *(**alloc_func) (size_t),
+				void *(**realloc_func) (void *, size_t, size_t),
+				void (**free_func) (void *, size_t))
+{
+  if (alloc_func)
+    *alloc_func = gmp_thread_allocate_func;
+
+  if (realloc_func)
+    *realloc_func = gmp_thread_reallocate_func;
+
+  if (free_func)
+    *free_func = gmp_thread_free_func;
+}
+
+void
+mp_set_thread_memory_functions (void *(*alloc_func) (size_t),
+				void *(*realloc_func) (void *, size_t, size_t),
+				void (*free_func) (void *, size_t))
+{
+  gmp_thread_allocate_func = alloc_func;
+  gmp_thread_reallocate_func = realloc_func;
+  gmp_thread_free_func = free_func;
+}
+
+#define gmp_alloc(size) ((*gmp_current_allocate_func)((size)))
+#define gmp_free(p, size) ((*gmp_current_free_func) ((p), (size)))
+#define gmp_realloc(ptr, old_size, size) ((*gmp_current_reallocate_func)(ptr, old_size, size))
 
 static mp_ptr
 gmp_alloc_limbs (mp_size_t size)
@@ -546,6 +594,36 @@ mini_gmp_mpn_rshift_scalar (mp_ptr rp, mp_srcptr up, mp_size_t n, unsigned int c
   return retval;
 }
 
+/* Operands of MINI_GMP_DISPATCH_SHIFT_MIN limbs or more (see
+   mini-gmp-dispatch.h) go to the vector shift kernels selected at run time
+   in mini-gmp-dispatch.c; they return 0 when the level has none.  The limb
+   shifted out is read here, before an in-place shift overwrites it.
+   Callers shift straight into the destination at its limb offset, so
+   mpz_mul_2exp and mpz_tdiv_q_2exp copy and shift in one pass. */
+static inline mp_limb_t
+mini_gmp_mpn_lshift (mp_ptr rp, mp_srcptr up, mp_size_t n, unsigned int cnt)
+{
+  if (n >= MINI_GMP_DISPATCH_SHIFT_MIN)
+    {
+      const mp_limb_t retval = up[n - 1] >> (GMP_LIMB_BITS - cnt);
+      if (mini_gmp_dispatch_lshift (rp, up, n, cnt))
+	return retval;
+    }
+  return mini_gmp_mpn_lshift_scalar (rp, up, n, cnt);
+}
+
+static inline mp_limb_t
+mini_gmp_mpn_rshift (mp_ptr rp, mp_srcptr up, mp_size_t n, unsigned int cnt)
+{
+  if (n >= MINI_GMP_DISPATCH_SHIFT_MIN)
+    {
+      const mp_limb_t retval = up[0] << (GMP_LIMB_BITS - cnt);
+      if (mini_gmp_dispatch_rshift (rp, up, n, cnt))
+	return retval;
+    }
+  return mini_gmp_mpn_rshift_scalar (rp, up, n, cnt);
+}
+
 #ifndef MINI_GMP_SIMD
 int
 mpn_cmp (mp_srcptr ap, mp_srcptr bp, mp_size_t n)
@@ -571,14 +649,6 @@ mpn_normalized_size (mp_srcptr xp, mp_size_t n)
   return n;
 }
 
-#ifndef MINI_GMP_SIMD
-int
-mpn_zero_p(mp_srcptr rp, mp_size_t n)
-{
-  return mpn_normalized_size (rp, n) == 0;
-}
-#endif /* MINI_GMP_SIMD */
-
 #ifndef MINI_GMP_SIMD
 void
 mpn_zero (mp_ptr rp, mp_size_t n)
@@ -621,11 +691,40 @@ mpn_add_1 (mp_ptr rp, mp_srcptr ap, mp_size_t n, mp_limb_t b)
   return b;
 }
 
+/* Carry-save AVX2 / AVX-512 kernels for long operands, selected at run
+   time in mini-gmp-dispatch.c; they return -1 when the level or the size
+   has none, otherwise the carry.  Operands shorter than
+   MINI_GMP_DISPATCH_ADD_MIN (mini-gmp-dispatch.h) stay on the adc chain
+   without the call. */
+static inline mp_limb_t
+mini_gmp_mpn_add_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+{
+  if (n >= MINI_GMP_DISPATCH_ADD_MIN)
+    {
+      const int cy = mini_gmp_dispatch_add_n (rp, ap, bp, n);
+      if (cy >= 0)
+	return (mp_limb_t) cy;
+    }
+  return mini_gmp_mpn_add_n_scalar (rp, ap, bp, n);
+}
+
+static inline mp_limb_t
+mini_gmp_mpn_sub_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+{
+  if (n >= MINI_GMP_DISPATCH_ADD_MIN)
+    {
+      const int cy = mini_gmp_dispatch_sub_n (rp, ap, bp, n);
+      if (cy >= 0)
+	return (mp_limb_t) cy;
+    }
+  return mini_gmp_mpn_sub_n_scalar (rp, ap, bp, n);
+}
+
 #ifndef MINI_GMP_SIMD
 mp_limb_t
 mpn_add_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
 {
-  return mini_gmp_mpn_add_n_scalar (rp, ap, bp, n);
+  return mini_gmp_mpn_add_n (rp, ap, bp, n);
 }
 #endif /* MINI_GMP_SIMD */
 
@@ -667,7 +766,7 @@ mpn_sub_1 (mp_ptr rp, mp_srcptr ap, mp_size_t n, mp_limb_t b)
 mp_limb_t
 mpn_sub_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
 {
-  return mini_gmp_mpn_sub_n_scalar (rp, ap, bp, n);
+  return mini_gmp_mpn_sub_n (rp, ap, bp, n);
 }
 #endif /* MINI_GMP_SIMD */
 
@@ -678,7 +777,7 @@ mpn_add (mp_ptr rp, mp_srcptr ap, mp_size_t an, mp_srcptr bp, mp_size_t bn)
 
   assert (an >= bn);
 
-  cy = mini_gmp_mpn_add_n_scalar (rp, ap, bp, bn);
+  cy = mini_gmp_mpn_add_n (rp, ap, bp, bn);
   if (an > bn)
     cy = mpn_add_1 (rp + bn, ap + bn, an - bn, cy);
   return cy;
@@ -691,12 +790,124 @@ mpn_sub (mp_ptr rp, mp_srcptr ap, mp_size_t an, mp_srcptr bp, mp_size_t bn)
 
   assert (an >= bn);
 
-  cy = mini_gmp_mpn_sub_n_scalar (rp, ap, bp, bn);
+  cy = mini_gmp_mpn_sub_n (rp, ap, bp, bn);
   if (an > bn)
     cy = mpn_sub_1 (rp + bn, ap + bn, an - bn, cy);
   return cy;
 }
 
+/* {rp, an} = {ap, an} + ({bp, bn} << cnt), for an >= bn > 0 and
+   cnt < GMP_LIMB_BITS, in one pass without materializing the shifted
+   operand.  Returns the high limb that does not fit in an limbs (at most
+   2^cnt).  rp may be equal to ap or to bp.  */
+mp_limb_t
+mpn_addlsh (mp_ptr rp, mp_srcptr ap, mp_size_t an, mp_srcptr bp, mp_size_t bn,
+	    unsigned int cnt)
+{
+  mp_limb_t high, cy;
+  unsigned int tnc;
+  mp_size_t i;
+
+  assert (an >= bn);
+  assert (bn > 0);
+  assert (cnt < GMP_LIMB_BITS);
+
+  if (cnt == 0)
+    return mpn_add (rp, ap, an, bp, bn);
+
+  tnc = GMP_LIMB_BITS - cnt;
+  high = 0;
+  cy = 0;
+  for (i = 0; i < bn; i++)
+    {
+      mp_limb_t b = bp[i];
+      mp_limb_t s = (b << cnt) | high;
+      mp_limb_t r = ap[i] + cy;
+      high = b >> tnc;
+      cy = r < cy;
+      r += s;
+      cy += r < s;
+      rp[i] = r;
+    }
+  high += cy;
+  if (an > bn)
+    high = mpn_add_1 (rp + bn, ap + bn, an - bn, high);
+  return high;
+}
+
+/* {rp, an} = {ap, an} - ({bp, bn} << cnt), same conditions as mpn_addlsh.
+   Returns the high limb that could not be subtracted (at most 2^cnt).  */
+mp_limb_t
+mpn_sublsh (mp_ptr rp, mp_srcptr ap, mp_size_t an, mp_srcptr bp, mp_size_t bn,
+	    unsigned int cnt)
+{
+  mp_limb_t high, bw;
+  unsigned int tnc;
+  mp_size_t i;
+
+  assert (an >= bn);
+  assert (bn > 0);
+  assert (cnt < GMP_LIMB_BITS);
+
+  if (cnt == 0)
+    return mpn_sub (rp, ap, an, bp, bn);
+
+  tnc = GMP_LIMB_BITS - cnt;
+  high = 0;
+  bw = 0;
+  for (i = 0; i < bn; i++)
+    {
+      mp_limb_t b = bp[i];
+      mp_limb_t s = (b << cnt) | high;
+      mp_limb_t a = ap[i];
+      mp_limb_t r = a - s;
+      mp_limb_t bw1 = a < s;
+      high = b >> tnc;
+      rp[i] = r - bw;
+      bw = bw1 + (r < bw);
+    }
+  high += bw;
+  if (an > bn)
+    high = mpn_sub_1 (rp + bn, ap + bn, an - bn, high);
+  return high;
+}
+
+/* Sign of {ap, an} - ({bp, bn} << bits), for normalized operands, walking
+   the limbs of the shifted operand without materializing it.  */
+int
+mpn_cmplsh (mp_srcptr ap, mp_size_t an, mp_srcptr bp, mp_size_t bn,
+	    mp_bitcnt_t bits)
+{
+  mp_size_t limbs = bits / GMP_LIMB_BITS;
+  unsigned int shift = bits % GMP_LIMB_BITS;
+  mp_size_t sn, i;
+
+  assert (an > 0 && ap[an - 1] != 0);
+  assert (bn > 0 && bp[bn - 1] != 0);
+
+  sn = bn + limbs + (shift > 0 && (bp[bn - 1] >> (GMP_LIMB_BITS - shift)) != 0);
+  if (an != sn)
+    return an < sn ? -1 : 1;
+
+  for (i = an - 1; i >= limbs; i--)
+    {
+      mp_size_t j = i - limbs;
+      mp_limb_t s = j < bn ? bp[j] << shift : 0;
+      if (shift > 0 && j > 0)
+	s |= bp[j - 1] >> (GMP_LIMB_BITS - shift);
+      if (ap[i] != s)
+	return ap[i] > s ? 1 : -1;
+    }
+  return (limbs == 0 || mpn_zero_p (ap, limbs)) ? 0 : 1;
+}
+
+/* The 128-bit product loops below keep one carry chain, two cycles per
+   limb.  Intrinsic versions with _mulx_u64 / _addcarryx_u64 and two
+   chains in flight (split halves, grouped limbs, a fused two-row
+   basecase) were measured with GCC 12: no faster than noise except at 2
+   limbs, which mpn_mul already special-cases, and 10-20% slower from 16
+   limbs up, as the compiler emits adc rather than adcx / adox and spills
+   the second chain.  Long products go to the IFMA kernels instead. */
 mp_limb_t
 mpn_mul_1 (mp_ptr rp, mp_srcptr up, mp_size_t n, mp_limb_t vl)
 {
@@ -831,17 +1042,19 @@ mini_gmp_mpn_mul_2x2 (mp_ptr rp, mp_srcptr up, mp_srcptr vp)
 #endif
 }
 
-mp_limb_t
-mpn_mul (mp_ptr rp, mp_srcptr up, mp_size_t un, mp_srcptr vp, mp_size_t vn)
+/* Products from MINI_GMP_DISPATCH_MUL_MIN limbs (mini-gmp-dispatch.h) first
+   ask mini-gmp-dispatch.c for a kernel (AVX-512 IFMA in radix 2^52), which
+   returns 0 when the CPU, the level or the size has none. */
+static mp_limb_t
+mini_gmp_mpn_mul_serial (mp_ptr rp, mp_srcptr up, mp_size_t un, mp_srcptr vp, mp_size_t vn)
 {
-  assert (un >= vn);
-  assert (vn >= 1);
-  assert (!GMP_MPN_OVERLAP_P(rp, un + vn, up, un));
-  assert (!GMP_MPN_OVERLAP_P(rp, un + vn, vp, vn));
-
   if (un == 2 && vn == 2)
     return mini_gmp_mpn_mul_2x2 (rp, up, vp);
 
+  if (vn >= MINI_GMP_DISPATCH_MUL_MIN
+      && mini_gmp_dispatch_mul (rp, up, un, vp, vn))
+    return rp[un + vn - 1];
+
   /* We first multiply by the low order limb. This result can be
      stored, not added, to rp. We also avoid a loop for zeroing this
      way. */
@@ -859,6 +1072,109 @@ mpn_mul (mp_ptr rp, mp_srcptr up, mp_size_t un, mp_srcptr vp, mp_size_t vn)
   return rp[un];
 }
 
+/* Fork-join on the task pool of mini-gmp-parallel.cpp.  mpn_mul splits
+   products whose shorter operand has MINI_GMP_PARALLEL_MUL_MIN limbs or
+   more when mini_gmp_threads () allows it; the blocks stop splitting at
+   about MINI_GMP_PARALLEL_GRAIN limb products (a millisecond or so). */
+#define MINI_GMP_PARALLEL_MUL_MIN 512
+#define MINI_GMP_PARALLEL_GRAIN ((mp_size_t) 1 << 20)
+
+struct mini_gmp_par;
+struct mini_gmp_par *mini_gmp_par_begin (int);
+void mini_gmp_par_end (struct mini_gmp_par *);
+void mini_gmp_par_do2 (struct mini_gmp_par *, void (*) (void *), void *,
+		       void (*) (void *), void *);
+
+struct mini_gmp_mul_args
+{
+  mp_ptr rp;
+  mp_srcptr up, vp;
+  mp_size_t un, vn;
+  struct mini_gmp_par *par;
+};
+
+static void mini_gmp_mpn_mul_task (void *);
+
+/* The longer operand is cut in two: the low part's product goes straight
+   to rp, the high part's to a temporary added in at its offset, so the
+   two halves share no output. */
+static void
+mini_gmp_mpn_mul_par (mp_ptr rp, mp_srcptr up, mp_size_t un, mp_srcptr vp, mp_size_t vn,
+	     struct mini_gmp_par *par)
+{
+  struct mini_gmp_mul_args lo, hi;
+  mp_size_t h, tn;
+  mp_ptr tp;
+  mp_limb_t cy;
+
+  if (un < vn)
+    {
+      MP_SRCPTR_SWAP (up, vp);
+      MP_SIZE_T_SWAP (un, vn);
+    }
+  if (un <= MINI_GMP_PARALLEL_GRAIN / vn)
+    {
+      mini_gmp_mpn_mul_serial (rp, up, un, vp, vn);
+      return;
+    }
+
+  h = un / 2;
+  tn = un - h + vn;
+  tp = gmp_alloc_limbs (tn);
+
+  lo.rp = rp; lo.up = up; lo.un = h; lo.vp = vp; lo.vn = vn; lo.par = par;
+  hi.rp = tp; hi.up = up + h; hi.un = un - h; hi.vp = vp; hi.vn = vn; hi.par = par;
+  mini_gmp_par_do2 (par, mini_gmp_mpn_mul_task, &lo, mini_gmp_mpn_mul_task, &hi);
+
+  mpn_copyi (rp + h + vn, tp + vn, un - h);
+  cy = mpn_add_n (rp + h, rp + h, tp, vn);
+  if (cy)
+    gmp_assert_nocarry (mpn_add_1 (rp + h + vn, rp + h + vn, un - h, cy));
+  gmp_free_limbs (tp, tn);
+}
+
+static void
+mini_gmp_mpn_mul_task (void *p)
+{
+  const struct mini_gmp_mul_args *a = (const struct mini_gmp_mul_args *) p;
+  mini_gmp_mpn_mul_par (a->rp, a->up, a->un, a->vp, a->vn, a->par);
+}
+
+mp_limb_t
+mpn_mul_threads (mp_ptr rp, mp_srcptr up, mp_size_t un, mp_srcptr vp, mp_size_t vn,
+		 int threads)
+{
+  struct mini_gmp_par *par;
+
+  assert (un >= vn);
+  assert (vn >= 1);
+  assert (!GMP_MPN_OVERLAP_P(rp, un + vn, up, un));
+  assert (!GMP_MPN_OVERLAP_P(rp, un + vn, vp, vn));
+
+  if (threads <= 1 || un <= MINI_GMP_PARALLEL_GRAIN / vn)
+    return mini_gmp_mpn_mul_serial (rp, up, un, vp, vn);
+
+  par = mini_gmp_par_begin (threads);
+  mini_gmp_mpn_mul_par (rp, up, un, vp, vn, par);
+  mini_gmp_par_end (par);
+  return rp[un + vn - 1];
+}
+
+mp_limb_t
+mpn_mul (mp_ptr rp, mp_srcptr up, mp_size_t un, mp_srcptr vp, mp_size_t vn)
+{
+  int threads;
+
+  assert (un >= vn);
+  assert (vn >= 1);
+  assert (!GMP_MPN_OVERLAP_P(rp, un + vn, up, un));
+  assert (!GMP_MPN_OVERLAP_P(rp, un + vn, vp, vn));
+
+  if (vn >= MINI_GMP_PARALLEL_MUL_MIN && (threads = mini_gmp_threads ()) > 1)
+    return mpn_mul_threads (rp, up, un, vp, vn, threads);
+  return mini_gmp_mpn_mul_serial (rp, up, un, vp, vn);
+}
+
 void
 mpn_mul_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
 {
@@ -871,11 +1187,46 @@ mpn_sqr (mp_ptr rp, mp_srcptr ap, mp_size_t n)
   mpn_mul (rp, ap, n, ap, n);
 }
 
+/* {rp, n} = {ap, n} * {bp, n} / 2^(n * GMP_LIMB_BITS) mod {mp, n}, for odd
+   m and a, b < m (Montgomery multiplication).  rp may be equal to ap or bp.
+   The reduction is GMP's redc_1: each step adds q * m with q chosen to
+   clear the low limb, and keeps the carry in that limb for one final
+   addition. */
+void
+mpn_montmul (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_srcptr mp, mp_size_t n)
+{
+  mp_ptr tp;
+  mp_limb_t minv, cy;
+  mp_size_t i;
+
+  assert (n >= 1);
+  assert (mp[0] & 1);
+
+  /* -1/m mod B by Newton's iteration, from 3 correct bits. */
+  minv = mp[0];
+  for (i = 0; i < 5; i++)
+    minv *= 2 - mp[0] * minv;
+  minv = -minv;
+
+  if (n >= MINI_GMP_DISPATCH_MUL_MIN
+      && mini_gmp_dispatch_montmul (rp, ap, bp, mp, n, minv))
+    return;
+
+  tp = gmp_alloc_limbs (2 * n);
+  mpn_mul_n (tp, ap, bp, n);
+  for (i = 0; i < n; i++)
+    tp[i] = mpn_addmul_1 (tp + i, mp, n, tp[i] * minv);
+  cy = mpn_add_n (rp, tp + n, tp, n);
+  if (cy != 0 || mpn_cmp (rp, mp, n) >= 0)
+    mpn_sub_n (rp, rp, mp, n);
+  gmp_free_limbs (tp, 2 * n);
+}
+
 #ifndef MINI_GMP_SIMD
 mp_limb_t
 mpn_lshift (mp_ptr rp, mp_srcptr up, mp_size_t n, unsigned int cnt)
 {
-  return mini_gmp_mpn_lshift_scalar (rp, up, n, cnt);
+  return mini_gmp_mpn_lshift (rp, up, n, cnt);
 }
 #endif /* MINI_GMP_SIMD */
 
@@ -883,7 +1234,7 @@ mpn_lshift (mp_ptr rp, mp_srcptr up, mp_size_t n, unsigned int cnt)
 mp_limb_t
 mpn_rshift (mp_ptr rp, mp_srcptr up, mp_size_t n, unsigned int cnt)
 {
-  return mini_gmp_mpn_rshift_scalar (rp, up, n, cnt);
+  return mini_gmp_mpn_rshift (rp, up, n, cnt);
 }
 #endif /* MINI_GMP_SIMD */
 
@@ -927,15 +1278,6 @@ mpn_scan0 (mp_srcptr ptr, mp_bitcnt_t bit)
 			  i, ptr, i, GMP_LIMB_MAX);
 }
 
-#ifndef MINI_GMP_SIMD
-void
-mpn_com (mp_ptr rp, mp_srcptr up, mp_size_t n)
-{
-  while (--n >= 0)
-    *rp++ = ~ *up++;
-}
-#endif /* MINI_GMP_SIMD */
-
 mp_limb_t
 mpn_neg (mp_ptr rp, mp_srcptr up, mp_size_t n)
 {
@@ -951,29 +1293,6 @@ mpn_neg (mp_ptr rp, mp_srcptr up, mp_size_t n)
   return 1;
 }
 
-#ifndef MINI_GMP_SIMD
-void
-mpn_and_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
-{
-  while (--n >= 0)
-    rp[n] = ap[n] & bp[n];
-}
-
-void
-mpn_ior_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
-{
-  while (--n >= 0)
-    rp[n] = ap[n] | bp[n];
-}
-
-void
-mpn_xor_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
-{
-  while (--n >= 0)
-    rp[n] = ap[n] ^ bp[n];
-}
-#endif /* MINI_GMP_SIMD */
-
 
 /* MPN division interface. */
 
@@ -1182,7 +1501,7 @@ mpn_div_qr_1_preinv (mp_ptr qp, mp_srcptr np, mp_size_t nn,
 	   tn = nn;
 	   tp = gmp_alloc_limbs (tn);
         }
-      r = mini_gmp_mpn_lshift_scalar (tp, np, nn, inv->shift);
+      r = mini_gmp_mpn_lshift (tp, np, nn, inv->shift);
       np = tp;
     }
   else
@@ -1219,7 +1538,7 @@ mpn_div_qr_2_preinv (mp_ptr qp, mp_ptr np, mp_size_t nn,
   di = inv->di;
 
   if (shift > 0)
-    r1 = mini_gmp_mpn_lshift_scalar (np, np, nn, shift);
+    r1 = mini_gmp_mpn_lshift (np, np, nn, shift);
   else
     r1 = 0;
 
@@ -1334,14 +1653,14 @@ mpn_div_qr_preinv (mp_ptr qp, mp_ptr np, mp_size_t nn,
 
       shift = inv->shift;
       if (shift > 0)
-	nh = mini_gmp_mpn_lshift_scalar (np, np, nn, shift);
+	nh = mini_gmp_mpn_lshift (np, np, nn, shift);
       else
 	nh = 0;
 
       mpn_div_qr_pi1 (qp, np, nn, nh, dp, dn, inv->di);
 
       if (shift > 0)
-	gmp_assert_nocarry (mini_gmp_mpn_rshift_scalar (np, np, dn, shift));
+	gmp_assert_nocarry (mini_gmp_mpn_rshift (np, np, dn, shift));
     }
 }
 
@@ -1358,7 +1677,7 @@ mpn_div_qr (mp_ptr qp, mp_ptr np, mp_size_t nn, mp_srcptr dp, mp_size_t dn)
   if (dn > 2 && inv.shift > 0)
     {
       tp = gmp_alloc_limbs (dn);
-      gmp_assert_nocarry (mini_gmp_mpn_lshift_scalar (tp, dp, dn, inv.shift));
+      gmp_assert_nocarry (mini_gmp_mpn_lshift (tp, dp, dn, inv.shift));
       dp = tp;
     }
   mpn_div_qr_preinv (qp, np, nn, dp, dn, &inv);
@@ -2400,8 +2719,10 @@ mpz_mul_ui (mpz_t r, const mpz_t u, unsigned long int v)
     r->_mp_size = (u->_mp_size < 0) ? -rn : rn;
 }
 
-void
-mpz_mul (mpz_t r, const mpz_t u, const mpz_t v)
+/* threads: the thread budget of mpn_mul_threads, 0 for mpn_mul's global
+   one.  mpz_mul passes a constant 0, which folds away. */
+static inline void
+mpz_mul_impl (mpz_t r, const mpz_t u, const mpz_t v, int threads)
 {
   int sign;
   mp_size_t un, vn, rn;
@@ -2458,10 +2779,15 @@ mpz_mul (mpz_t r, const mpz_t u, const mpz_t v)
   } else {
       tp = MPZ_REALLOC(r, (un + vn));
   }
-  if (un >= vn)
-    mpn_mul (tp, u->_mp_d, un, v->_mp_d, vn);
+  if (un < vn)
+    {
+      MPZ_SRCPTR_SWAP (u, v);
+      MP_SIZE_T_SWAP (un, vn);
+    }
+  if (threads > 0)
+    mpn_mul_threads (tp, u->_mp_d, un, v->_mp_d, vn, threads);
   else
-    mpn_mul (tp, v->_mp_d, vn, u->_mp_d, un);
+    mpn_mul (tp, u->_mp_d, un, v->_mp_d, vn);
 
   rn = un + vn;
   rn -= tp[rn-1] == 0;
@@ -2475,6 +2801,18 @@ mpz_mul (mpz_t r, const mpz_t u, const mpz_t v)
   }
 }
 
+void
+mpz_mul (mpz_t r, const mpz_t u, const mpz_t v)
+{
+  mpz_mul_impl (r, u, v, 0);
+}
+
+void
+mpz_mul_threads (mpz_t r, const mpz_t u, const mpz_t v, int threads)
+{
+  mpz_mul_impl (r, u, v, threads < 1 ? 1 : threads);
+}
+
 void
 mpz_mul_2exp (mpz_t r, const mpz_t u, mp_bitcnt_t bits)
 {
@@ -2497,7 +2835,7 @@ mpz_mul_2exp (mpz_t r, const mpz_t u, mp_bitcnt_t bits)
   rp = MPZ_REALLOC (r, rn);
   if (shift > 0)
     {
-      mp_limb_t cy = mini_gmp_mpn_lshift_scalar (rp + limbs, u->_mp_d, un, shift);
+      mp_limb_t cy = mini_gmp_mpn_lshift (rp + limbs, u->_mp_d, un, shift);
       rp[rn-1] = cy;
       rn -= (cy == 0);
     }
@@ -2613,6 +2951,79 @@ mpz_aorsmul_fast (mpz_t r, const mpz_t u, const mpz_t v, int add)
 }
 #endif /* MINI_GMP_PLUS_BUFF_SIZE */
 
+/* r += (add ? +1 : -1) * u * 2^bits, shifting u on the fly with
+   mpn_addlsh / mpn_sublsh instead of building u * 2^bits in a temporary.
+   r's own limbs are only grown, so this allocates nothing when r has room
+   for the result.  */
+static void
+mpz_aorsmul_2exp (mpz_t r, const mpz_t u, mp_bitcnt_t bits, int add)
+{
+  mp_size_t un = GMP_ABS (u->_mp_size);
+  mp_size_t rn, n, limbs;
+  unsigned shift;
+  int r_neg, u_neg;
+  mp_ptr rp;
+
+  if (un == 0)
+    return;
+
+  if (r == u)
+    {
+      mpz_t t;
+      mpz_init (t);
+      mpz_mul_2exp (t, u, bits);
+      if (add)
+	mpz_add (r, r, t);
+      else
+	mpz_sub (r, r, t);
+      mpz_clear (t);
+      return;
+    }
+
+  limbs = bits / GMP_LIMB_BITS;
+  shift = bits % GMP_LIMB_BITS;
+
+  rn = GMP_ABS (r->_mp_size);
+  u_neg = (u->_mp_size < 0) ^ !add;
+  r_neg = rn > 0 ? r->_mp_size < 0 : u_neg;
+
+  /* u * 2^bits fits in limbs + un + 1 limbs; one more for the carry. */
+  n = GMP_MAX (rn, limbs + un + 1);
+  rp = MPZ_REALLOC (r, n + 1);
+  if (n > rn)
+    mpn_zero (rp + rn, n - rn);
+
+  if (r_neg == u_neg)
+    {
+      rp[n] = mpn_addlsh (rp + limbs, rp + limbs, n - limbs, u->_mp_d, un, shift);
+      rn = mpn_normalized_size (rp, n + 1);
+    }
+  else
+    {
+      /* A borrow means |u| * 2^bits > |r|: the n limbs hold the two's
+	 complement of the difference. */
+      if (mpn_sublsh (rp + limbs, rp + limbs, n - limbs, u->_mp_d, un, shift))
+	{
+	  mpn_neg (rp, rp, n);
+	  r_neg = !r_neg;
+	}
+      rn = mpn_normalized_size (rp, n);
+    }
+  r->_mp_size = r_neg ? - rn : rn;
+}
+
+void
+mpz_addmul_2exp (mpz_t r, const mpz_t u, mp_bitcnt_t bits)
+{
+  mpz_aorsmul_2exp (r, u, bits, 1);
+}
+
+void
+mpz_submul_2exp (mpz_t r, const mpz_t u, mp_bitcnt_t bits)
+{
+  mpz_aorsmul_2exp (r, u, bits, 0);
+}
+
 void
 mpz_addmul (mpz_t r, const mpz_t u, const mpz_t v)
 {
@@ -2859,7 +3270,7 @@ mpz_div_q_2exp (mpz_t q, const mpz_t u, mp_bitcnt_t bit_index,
 
       if (bit_index != 0)
 	{
-	  mini_gmp_mpn_rshift_scalar (qp, u->_mp_d + limb_cnt, qn, bit_index);
+	  mini_gmp_mpn_rshift (qp, u->_mp_d + limb_cnt, qn, bit_index);
 	  qn -= qp[qn - 1] == 0;
 	}
       else
@@ -3547,8 +3958,10 @@ mpz_ui_pow_ui (mpz_t r, unsigned long blimb, unsigned long e)
   mpz_clear (b);
 }
 
-void
-mpz_powm (mpz_t r, const mpz_t b, const mpz_t e, const mpz_t m)
+/* threads: as for mpz_mul_impl, the budget of the squarings and
+   products. */
+static void
+mpz_powm_impl (mpz_t r, const mpz_t b, const mpz_t e, const mpz_t m, int threads)
 {
   mpz_t tr;
   mpz_t base;
@@ -3580,7 +3993,7 @@ mpz_powm (mpz_t r, const mpz_t b, const mpz_t e, const mpz_t m)
       minv.shift = 0;
 
       tp = gmp_alloc_limbs (mn);
-      gmp_assert_nocarry (mini_gmp_mpn_lshift_scalar (tp, mp, mn, shift));
+      gmp_assert_nocarry (mini_gmp_mpn_lshift (tp, mp, mn, shift));
       mp = tp;
     }
 
@@ -3624,9 +4037,9 @@ mpz_powm (mpz_t r, const mpz_t b, const mpz_t e, const mpz_t m)
       bit = GMP_LIMB_HIGHBIT;
       do
 	{
-	  mpz_mul (tr, tr, tr);
+	  mpz_mul_impl (tr, tr, tr, threads);
 	  if (w & bit)
-	    mpz_mul (tr, tr, base);
+	    mpz_mul_impl (tr, tr, base, threads);
 	  if (tr->_mp_size > mn)
 	    {
 	      mpn_div_qr_preinv (NULL, tr->_mp_d, tr->_mp_size, mp, mn, &minv);
@@ -3652,6 +4065,12 @@ mpz_powm (mpz_t r, const mpz_t b, const mpz_t e, const mpz_t m)
   mpz_clear (base);
 }
 
+void
+mpz_powm (mpz_t r, const mpz_t b, const mpz_t e, const mpz_t m)
+{
+  mpz_powm_impl (r, b, e, m, 0);
+}
+
 void
 mpz_powm_ui (mpz_t r, const mpz_t b, unsigned long elimb, const mpz_t m)
 {
@@ -3794,15 +4213,216 @@ mpn_sqrtrem (mp_ptr sp, mp_ptr rp, mp_srcptr p, mp_size_t n)
   return res;
 }
 
+/* Batches */
+
+/* The batch functions apply one operation to n independent elements.  The
+   range is halved down to about n / (8 threads) elements per task, enough
+   for the work stealing to even out elements of unequal cost.  Each element
+   runs on whichever thread took its range, with a budget of one thread for
+   its own products, so large operands never fork again inside the
+   batch. */
+struct mini_gmp_batch_args
+{
+  void (*op) (mpz_ptr, mpz_srcptr, mpz_srcptr, mpz_srcptr);
+  mpz_ptr r;
+  mpz_srcptr a, b, c;
+  size_t n, grain;
+  struct mini_gmp_par *par;
+};
+
+static void
+mini_gmp_batch_task (void *p)
+{
+  const struct mini_gmp_batch_args *t = (const struct mini_gmp_batch_args *) p;
+  size_t i;
+
+  if (t->n > t->grain)
+    {
+      struct mini_gmp_batch_args lo = *t, hi = *t;
+      const size_t h = t->n / 2;
+
+      lo.n = h;
+      hi.r += h; hi.a += h; hi.b += h; hi.n -= h;
+      if (hi.c != NULL)
+	hi.c += h;
+      mini_gmp_par_do2 (t->par, mini_gmp_batch_task, &lo, mini_gmp_batch_task, &hi);
+      return;
+    }
+
+  for (i = 0; i < t->n; i++)
+    t->op (t->r + i, t->a + i, t->b + i, t->c != NULL ? t->c + i : NULL);
+}
+
+static void
+mini_gmp_batch (void (*op) (mpz_ptr, mpz_srcptr, mpz_srcptr, mpz_srcptr),
+		mpz_ptr r, mpz_srcptr a, mpz_srcptr b, mpz_srcptr c,
+		size_t n, int threads)
+{
+  struct mini_gmp_batch_args t;
+
+  t.op = op;
+  t.r = r; t.a = a; t.b = b; t.c = c;
+  t.n = n;
+  t.grain = threads > 1 ? n / (8 * (size_t) threads) : n;
+  if (t.grain == 0)
+    t.grain = 1;
+  t.par = mini_gmp_par_begin (threads);
+  mini_gmp_batch_task (&t);
+  mini_gmp_par_end (t.par);
+}
+
+static void
+mini_gmp_batch_mul (mpz_ptr r, mpz_srcptr a, mpz_srcptr b, mpz_srcptr c)
+{
+  (void) c;
+  mpz_mul_impl (r, a, b, 1);
+}
+
+static void
+mini_gmp_batch_gcd (mpz_ptr r, mpz_srcptr a, mpz_srcptr b, mpz_srcptr c)
+{
+  (void) c;
+  mpz_gcd (r, a, b);
+}
+
+static void
+mini_gmp_batch_powm (mpz_ptr r, mpz_srcptr b, mpz_srcptr e, mpz_srcptr m)
+{
+  mpz_powm_impl (r, b, e, m, 1);
+}
+
+void
+mpz_mul_batch (mpz_ptr r, mpz_srcptr a, mpz_srcptr b, size_t n, int threads)
+{
+  mini_gmp_batch (mini_gmp_batch_mul, r, a, b, NULL, n, threads);
+}
+
+void
+mpz_gcd_batch (mpz_ptr r, mpz_srcptr a, mpz_srcptr b, size_t n, int threads)
+{
+  mini_gmp_batch (mini_gmp_batch_gcd, r, a, b, NULL, n, threads);
+}
+
+void
+mpz_powm_batch (mpz_ptr r, mpz_srcptr b, mpz_srcptr e, mpz_srcptr m,
+		size_t n, int threads)
+{
+  mini_gmp_batch (mini_gmp_batch_powm, r, b, e, m, n, threads);
+}
+
+
 /* Combinatorics */
 
+/* Product trees over the factors of mpz_mfac_uiui and mpz_bin_uiui.  The
+   factors are first packed into limbs, as many per limb as fit, then
+   multiplied by balanced binary splitting so that the large products get
+   operands of equal size.  With more than one thread the two halves of a
+   node of MINI_GMP_PARALLEL_PROD_MIN limbs or more run on the task pool,
+   each with half the threads, and the node's own product uses them all. */
+#define MINI_GMP_PROD_LEAF 16
+#define MINI_GMP_PARALLEL_PROD_MIN (2 * MINI_GMP_PARALLEL_MUL_MIN)
+
+/* Packs the c terms a, a - m, a - 2m, ..., all nonzero, into fp, and
+   returns the number of limbs written (at most c, 1 for c = 0). */
+static mp_size_t
+gmp_pack_factors (mp_ptr fp, unsigned long a, unsigned long m, unsigned long c)
+{
+  mp_size_t n = 0;
+  mp_limb_t p = 1;
+
+  for (; c > 0; c--, a -= m)
+    {
+      mp_limb_t hi, lo;
+      gmp_umul_ppmm (hi, lo, p, (mp_limb_t) a);
+      if (hi != 0)
+	{
+	  fp[n++] = p;
+	  p = a;
+	}
+      else
+	p = lo;
+    }
+  fp[n++] = p;
+  return n;
+}
+
+struct mini_gmp_prod_args
+{
+  mpz_ptr r;
+  mp_srcptr fp;
+  mp_size_t n;
+  int threads;
+};
+
+static void mini_gmp_prod_task (void *);
+
+/* r = fp[0] fp[1] ... fp[n-1], for n >= 1 nonzero limbs. */
+static void
+mpz_prod_limbs (mpz_t r, mp_srcptr fp, mp_size_t n, int threads)
+{
+  struct mini_gmp_prod_args lo, hi;
+  mpz_t t;
+
+  if (n <= MINI_GMP_PROD_LEAF)
+    {
+      mp_ptr rp = MPZ_REALLOC (r, n);
+      mp_size_t i, rn;
+
+      rp[0] = fp[0];
+      for (i = rn = 1; i < n; i++)
+	{
+	  rp[rn] = mpn_mul_1 (rp, rp, rn, fp[i]);
+	  rn += rp[rn] != 0;
+	}
+      r->_mp_size = rn;
+      return;
+    }
+
+  mpz_init (t);
+  lo.r = r; lo.fp = fp; lo.n = n / 2;
+  hi.r = t; hi.fp = fp + n / 2; hi.n = n - n / 2;
+  if (threads > 1 && n >= MINI_GMP_PARALLEL_PROD_MIN)
+    {
+      struct mini_gmp_par *par = mini_gmp_par_begin (2);
+      lo.threads = threads - threads / 2;
+      hi.threads = threads / 2;
+      mini_gmp_par_do2 (par, mini_gmp_prod_task, &lo, mini_gmp_prod_task, &hi);
+      mini_gmp_par_end (par);
+    }
+  else
+    {
+      lo.threads = hi.threads = threads;
+      mini_gmp_prod_task (&lo);
+      mini_gmp_prod_task (&hi);
+    }
+  mpz_mul_impl (r, r, t, threads);
+  mpz_clear (t);
+}
+
+static void
+mini_gmp_prod_task (void *p)
+{
+  const struct mini_gmp_prod_args *a = (const struct mini_gmp_prod_args *) p;
+  mpz_prod_limbs (a->r, a->fp, a->n, a->threads);
+}
+
 void
 mpz_mfac_uiui (mpz_t x, unsigned long n, unsigned long m)
 {
-  mpz_set_ui (x, n + (n == 0));
-  if (m + 1 < 2) return;
-  while (n > m + 1)
-    mpz_mul_ui (x, x, n -= m);
+  unsigned long c;
+  mp_ptr fp;
+
+  if (n < 2 || m + 1 < 2)
+    {
+      mpz_set_ui (x, n + (n == 0));
+      return;
+    }
+
+  /* The terms n - i m >= 2. */
+  c = 1 + (n - 2) / m;
+  fp = gmp_alloc_limbs (c);
+  mpz_prod_limbs (x, fp, gmp_pack_factors (fp, n, m, c), mini_gmp_threads ());
+  gmp_free_limbs (fp, c);
 }
 
 void
@@ -3821,23 +4441,35 @@ void
 mpz_bin_uiui (mpz_t r, unsigned long n, unsigned long k)
 {
   mpz_t t;
+  mp_ptr fp;
+  int threads;
 
-  mpz_set_ui (r, k <= n);
-
+  if (k > n)
+    {
+      r->_mp_size = 0;
+      return;
+    }
   if (k > (n >> 1))
-    k = (k <= n) ? n - k : 0;
+    k = n - k;
+  if (k < 2)
+    {
+      mpz_set_ui (r, k ? n : 1);
+      return;
+    }
 
+  /* n (n-1) ... (n-k+1) / k!, both products by their tree. */
+  threads = mini_gmp_threads ();
+  fp = gmp_alloc_limbs (k);
+  mpz_prod_limbs (r, fp, gmp_pack_factors (fp, n, 1, k), threads);
   mpz_init (t);
-  mpz_fac_ui (t, k);
-
-  for (; k > 0; --k)
-    mpz_mul_ui (r, r, n--);
+  mpz_prod_limbs (t, fp, gmp_pack_factors (fp, k, 1, k - 1), threads);
+  gmp_free_limbs (fp, k);
 
   mpz_divexact (r, r, t);
   mpz_clear (t);
 }
 
-
+
 /* Primality testing */
 
 /* Computes Kronecker (a/b) with odd b, a!=0 and GCD(a,b) = 1 */
@@ -4544,34 +5176,6 @@ gmp_popcount_limb (mp_limb_t x)
   return c;
 }
 
-#ifndef MINI_GMP_SIMD
-mp_bitcnt_t
-mpn_popcount (mp_srcptr p, mp_size_t n)
-{
-  mp_size_t i;
-  mp_bitcnt_t c;
-
-  for (c = 0, i = 0; i < n; i++)
-    c += gmp_popcount_limb (p[i]);
-
-  return c;
-}
-#endif /* MINI_GMP_SIMD */
-
-#ifndef MINI_GMP_SIMD
-mp_bitcnt_t
-mpn_hamdist (mp_srcptr ap, mp_srcptr bp, mp_size_t n)
-{
-  mp_size_t i;
-  mp_bitcnt_t c;
-
-  for (c = 0, i = 0; i < n; i++)
-    c += gmp_popcount_limb (ap[i] ^ bp[i]);
-
-  return c;
-}
-#endif /* MINI_GMP_SIMD */
-
 mp_bitcnt_t
 mpz_popcount (const mpz_t u)
 {
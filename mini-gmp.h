@@ -71,6 +71,15 @@ see https://www.gnu.org/licenses/.  */
 extern "C" {
 #endif
 
+/* Thread safety: besides the memory functions, the only global state is
+   the SIMD level and the thread budget (mini_gmp_set_simd_level and
+   mini_gmp_set_threads below), both atomic.  Functions may run
+   concurrently on different mpz_t, or on the same mpz_t if none of the
+   calls writes it.  mp_set_memory_functions must be called before other
+   threads use the library; everything else, the per-thread overrides
+   included, may be called at any time.  Errors (division by zero, zero
+   modulus, out of memory) print a message and abort(); nothing is
+   recoverable, so there is no error state to share. */
 MINI_GMP_PLUS_API void mp_set_memory_functions (void *(*) (size_t),
 			      void *(*) (void *, size_t, size_t),
 			      void (*) (void *, size_t));
@@ -79,6 +88,22 @@ MINI_GMP_PLUS_API void mp_get_memory_functions (void *(**) (size_t),
 	 		      void *(**) (void *, size_t, size_t),
 			      void (**) (void *, size_t));
 
+/* Memory functions of the calling thread only, each overriding the global
+   one unless NULL (the default; passing NULL removes an override).
+   mp_get_memory_functions returns the functions the calling thread uses.
+   The tasks of a parallel call run with the overrides of the calling
+   thread, so these must then be safe to call from the pool's threads.
+   Limbs must be reallocated and freed by the functions that allocated
+   them: an mpz_t passed between threads with different overrides has to
+   be cleared with the right ones in effect. */
+MINI_GMP_PLUS_API void mp_set_thread_memory_functions (void *(*) (size_t),
+			      void *(*) (void *, size_t, size_t),
+			      void (*) (void *, size_t));
+
+MINI_GMP_PLUS_API void mp_get_thread_memory_functions (void *(**) (size_t),
+			      void *(**) (void *, size_t, size_t),
+			      void (**) (void *, size_t));
+
 /* [Bruno Levy] 10/19/2025 mp_limb_t fixed as a uint64 (from <stdint.h>) */
 typedef uint64_t mp_limb_t;
 
@@ -130,13 +155,30 @@ MINI_GMP_PLUS_API mp_limb_t mpn_sub_1 (mp_ptr, mp_srcptr, mp_size_t, mp_limb_t);
 MINI_GMP_PLUS_API mp_limb_t mpn_sub_n (mp_ptr, mp_srcptr, mp_srcptr, mp_size_t);
 MINI_GMP_PLUS_API mp_limb_t mpn_sub (mp_ptr, mp_srcptr, mp_size_t, mp_srcptr, mp_size_t);
 
+/* Add/subtract/compare {bp, bn} << cnt without materializing the shift */
+MINI_GMP_PLUS_API mp_limb_t mpn_addlsh (mp_ptr, mp_srcptr, mp_size_t, mp_srcptr, mp_size_t, unsigned int);
+MINI_GMP_PLUS_API mp_limb_t mpn_sublsh (mp_ptr, mp_srcptr, mp_size_t, mp_srcptr, mp_size_t, unsigned int);
+MINI_GMP_PLUS_API int mpn_cmplsh (mp_srcptr, mp_size_t, mp_srcptr, mp_size_t, mp_bitcnt_t);
+
 MINI_GMP_PLUS_API mp_limb_t mpn_mul_1 (mp_ptr, mp_srcptr, mp_size_t, mp_limb_t);
 MINI_GMP_PLUS_API mp_limb_t mpn_addmul_1 (mp_ptr, mp_srcptr, mp_size_t, mp_limb_t);
 MINI_GMP_PLUS_API mp_limb_t mpn_submul_1 (mp_ptr, mp_srcptr, mp_size_t, mp_limb_t);
 
+/* mpn_mul_1 / mpn_addmul_1 on count independent n-limb operands at once,
+   stored interleaved: limb i of operand k is up[i * count + k], likewise
+   for rp.  Operand k is multiplied by vp[k] and its high limb stored in
+   cp[k].  rp may equal up; the other areas must not overlap. */
+MINI_GMP_PLUS_API void mpn_mul_1_batch (mp_ptr, mp_srcptr, mp_size_t, mp_srcptr, mp_ptr, mp_size_t);
+MINI_GMP_PLUS_API void mpn_addmul_1_batch (mp_ptr, mp_srcptr, mp_size_t, mp_srcptr, mp_ptr, mp_size_t);
+
 MINI_GMP_PLUS_API mp_limb_t mpn_mul (mp_ptr, mp_srcptr, mp_size_t, mp_srcptr, mp_size_t);
 MINI_GMP_PLUS_API void mpn_mul_n (mp_ptr, mp_srcptr, mp_srcptr, mp_size_t);
 MINI_GMP_PLUS_API void mpn_sqr (mp_ptr, mp_srcptr, mp_size_t);
+/* Montgomery multiplication: a * b / B^n mod m, for odd m and a, b < m */
+MINI_GMP_PLUS_API void mpn_montmul (mp_ptr, mp_srcptr, mp_srcptr, mp_srcptr, mp_size_t);
+/* mpn_mul on up to the given number of threads (the caller included), for
+   operands of thousands of limbs */
+MINI_GMP_PLUS_API mp_limb_t mpn_mul_threads (mp_ptr, mp_srcptr, mp_size_t, mp_srcptr, mp_size_t, int);
 MINI_GMP_PLUS_API int mpn_perfect_square_p (mp_srcptr, mp_size_t);
 MINI_GMP_PLUS_API mp_size_t mpn_sqrtrem (mp_ptr, mp_ptr, mp_srcptr, mp_size_t);
 
@@ -156,6 +198,37 @@ MINI_GMP_PLUS_API void mpn_xor_n (mp_ptr, mp_srcptr, mp_srcptr, mp_size_t);
 MINI_GMP_PLUS_API mp_bitcnt_t mpn_popcount (mp_srcptr, mp_size_t);
 MINI_GMP_PLUS_API mp_bitcnt_t mpn_hamdist (mp_srcptr, mp_srcptr, mp_size_t);
 
+/* Runtime SIMD dispatch (mini-gmp-dispatch.c) of mpn_popcount, mpn_hamdist,
+   mpn_and_n, mpn_ior_n, mpn_xor_n, mpn_com, mpn_zero_p, the batched
+   mpn_mul_1_batch / mpn_addmul_1_batch, of the carry-save kernels behind
+   mpn_add_n / mpn_sub_n from 8 limbs, of mpn_lshift / mpn_rshift from 6
+   limbs, and of the AVX-512 IFMA kernels
+   behind mpn_mul / mpn_sqr / mpn_montmul for 12 to 64 limbs.  The level is
+   one of "scalar", "xsimd", "avx2", "avx512"; the best one supported is
+   picked on first use, capped by the MINI_GMP_SIMD_LEVEL environment
+   variable.  mini_gmp_set_simd_level selects the best supported level not
+   above the given one and returns 1 if it got exactly that level, 0 if it
+   fell back, -1 for an unknown name. */
+MINI_GMP_PLUS_API const char *mini_gmp_simd_level (void);
+MINI_GMP_PLUS_API int mini_gmp_set_simd_level (const char *);
+
+/* Thread budget of mpn_mul / mpz_mul and the other parallel operations
+   (mini-gmp-parallel.cpp): 1 (serial) unless set here or by the
+   MINI_GMP_THREADS environment variable.  Products whose shorter operand
+   has 512 limbs or more then run on a shared work-stealing pool. */
+MINI_GMP_PLUS_API int mini_gmp_threads (void);
+MINI_GMP_PLUS_API void mini_gmp_set_threads (int);
+
+/* Batches of independent operations, r[i] = op (a[i], b[i]) for i < n
+   (op (b[i], e[i], m[i]) for mpz_powm_batch), spread over up to the given
+   number of threads (the caller included).  Each argument points to n
+   consecutive mpz_t, e.g. the first element of an mpz_t array; r may be
+   the same array as an operand.  An element of mpz_powm_batch with a zero
+   modulus aborts as mpz_powm does. */
+MINI_GMP_PLUS_API void mpz_mul_batch (mpz_ptr, mpz_srcptr, mpz_srcptr, size_t, int);
+MINI_GMP_PLUS_API void mpz_gcd_batch (mpz_ptr, mpz_srcptr, mpz_srcptr, size_t, int);
+MINI_GMP_PLUS_API void mpz_powm_batch (mpz_ptr, mpz_srcptr, mpz_srcptr, mpz_srcptr, size_t, int);
+
 MINI_GMP_PLUS_API mp_limb_t mpn_invert_3by2 (mp_limb_t, mp_limb_t);
 #define mpn_invert_limb(x) mpn_invert_3by2 ((x), 0)
 
@@ -191,11 +264,15 @@ MINI_GMP_PLUS_API void mpz_sub (mpz_t, const mpz_t, const mpz_t);
 MINI_GMP_PLUS_API void mpz_mul_si (mpz_t, const mpz_t, long int);
 MINI_GMP_PLUS_API void mpz_mul_ui (mpz_t, const mpz_t, unsigned long int);
 MINI_GMP_PLUS_API void mpz_mul (mpz_t, const mpz_t, const mpz_t);
+MINI_GMP_PLUS_API void mpz_mul_threads (mpz_t, const mpz_t, const mpz_t, int);
 MINI_GMP_PLUS_API void mpz_mul_2exp (mpz_t, const mpz_t, mp_bitcnt_t);
 MINI_GMP_PLUS_API void mpz_addmul_ui (mpz_t, const mpz_t, unsigned long int);
 MINI_GMP_PLUS_API void mpz_addmul (mpz_t, const mpz_t, const mpz_t);
 MINI_GMP_PLUS_API void mpz_submul_ui (mpz_t, const mpz_t, unsigned long int);
 MINI_GMP_PLUS_API void mpz_submul (mpz_t, const mpz_t, const mpz_t);
+/* r += u * 2^bits and r -= u * 2^bits without a shifted temporary */
+MINI_GMP_PLUS_API void mpz_addmul_2exp (mpz_t, const mpz_t, mp_bitcnt_t);
+MINI_GMP_PLUS_API void mpz_submul_2exp (mpz_t, const mpz_t, mp_bitcnt_t);
 
 MINI_GMP_PLUS_API void mpz_cdiv_qr (mpz_t, mpz_t, const mpz_t, const mpz_t);
 MINI_GMP_PLUS_API void mpz_fdiv_qr (mpz_t, mpz_t, const mpz_t, const mpz_t);
@@ -0,0 +1,86 @@
+/* Tests mpz_addmul_2exp and mpz_submul_2exp against mpz_mul_2exp followed
+   by mpz_add / mpz_sub, for random signs, sizes and shift counts.  */
+
+#include <limits.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "testutils.h"
+
+#define MAXBITS 400
+#define MAXSHIFT 300
+#define COUNT 10000
+
+void
+testmain (int argc, char **argv)
+{
+  unsigned i;
+  mpz_t r, u, t, res, ref;
+
+  mpz_init (r);
+  mpz_init (u);
+  mpz_init (t);
+  mpz_init (res);
+  mpz_init (ref);
+
+  for (i = 0; i < COUNT; i++)
+    {
+      mp_bitcnt_t bits;
+
+      mini_rrandomb (r, MAXBITS);
+      mini_rrandomb (u, MAXBITS);
+      mini_urandomb (t, 16);
+      bits = mpz_get_ui (t) % MAXSHIFT;
+      if (i & 2)
+	mpz_neg (r, r);
+      if (i & 4)
+	mpz_neg (u, u);
+      if (i % 16 == 8)
+	/* Exact cancellation. */
+	mpz_mul_2exp (r, u, bits);
+
+      mpz_mul_2exp (t, u, bits);
+      mpz_set (res, r);
+      if (i & 1)
+	{
+	  mpz_add (ref, r, t);
+	  mpz_addmul_2exp (res, u, bits);
+	}
+      else
+	{
+	  mpz_sub (ref, r, t);
+	  mpz_submul_2exp (res, u, bits);
+	}
+      if (mpz_cmp (res, ref))
+	{
+	  if (i & 1)
+	    fprintf (stderr, "mpz_addmul_2exp failed, bits = %lu:\n", (unsigned long) bits);
+	  else
+	    fprintf (stderr, "mpz_submul_2exp failed, bits = %lu:\n", (unsigned long) bits);
+	  dump ("r", r);
+	  dump ("u", u);
+	  dump ("res", res);
+	  dump ("ref", ref);
+	  abort ();
+	}
+
+      /* Aliased operands */
+      mpz_set (res, u);
+      mpz_mul_2exp (t, u, bits);
+      mpz_add (ref, u, t);
+      mpz_addmul_2exp (res, res, bits);
+      if (mpz_cmp (res, ref))
+	{
+	  fprintf (stderr, "mpz_addmul_2exp failed with r == u, bits = %lu:\n", (unsigned long) bits);
+	  dump ("u", u);
+	  dump ("res", res);
+	  dump ("ref", ref);
+	  abort ();
+	}
+    }
+  mpz_clear (r);
+  mpz_clear (u);
+  mpz_clear (t);
+  mpz_clear (res);
+  mpz_clear (ref);
+}
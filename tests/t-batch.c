@@ -0,0 +1,101 @@
+/* Tests mpz_mul_batch, mpz_gcd_batch and mpz_powm_batch against the
+   element-wise operations, serially and on several threads, with operands
+   of mixed sizes and signs and the result array reused as an operand.  */
+
+#include <limits.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "testutils.h"
+
+#define GMP_LIMB_BITS (sizeof(mp_limb_t) * CHAR_BIT)
+#define N 300
+
+static mpz_t a[N], b[N], m[N], r[N], ref[N];
+
+static void
+check (const char *op, int threads, size_t n)
+{
+  size_t i;
+  for (i = 0; i < n; i++)
+    if (mpz_cmp (r[i], ref[i]))
+      {
+	fprintf (stderr, "%s failed with %d threads, element %d of %d\n", op,
+		 threads, (int) i, (int) n);
+	dump ("a", a[i]);
+	dump ("b", b[i]);
+	dump ("r", r[i]);
+	dump ("ref", ref[i]);
+	abort ();
+      }
+}
+
+void
+testmain (int argc, char **argv)
+{
+  static const int threads[] = { 1, 2, 3, 8 };
+  static const size_t sizes[] = { 0, 1, 7, N };
+  size_t i, k;
+  unsigned j;
+
+  for (i = 0; i < N; i++)
+    {
+      mpz_init (a[i]);
+      mpz_init (b[i]);
+      mpz_init (m[i]);
+      mpz_init (r[i]);
+      mpz_init (ref[i]);
+      /* A few elements much larger than the others. */
+      mini_rrandomb (a[i], (i % 37 == 0 ? 40 : 1 + i % 5) * GMP_LIMB_BITS);
+      mini_rrandomb (b[i], (i % 37 == 0 ? 40 : 1 + i % 3) * GMP_LIMB_BITS);
+      mini_urandomb (m[i], (1 + i % 4) * GMP_LIMB_BITS);
+      if (i & 1)
+	mpz_neg (a[i], a[i]);
+      if (i & 2)
+	mpz_neg (b[i], b[i]);
+      if (mpz_sgn (m[i]) == 0)
+	mpz_set_ui (m[i], 1 + i);
+    }
+
+  for (j = 0; j < sizeof (threads) / sizeof (threads[0]); j++)
+    for (k = 0; k < sizeof (sizes) / sizeof (sizes[0]); k++)
+      {
+	const size_t n = sizes[k];
+
+	for (i = 0; i < n; i++)
+	  mpz_mul (ref[i], a[i], b[i]);
+	mpz_mul_batch (r[0], a[0], b[0], n, threads[j]);
+	check ("mpz_mul_batch", threads[j], n);
+
+	for (i = 0; i < n; i++)
+	  mpz_gcd (ref[i], a[i], b[i]);
+	mpz_gcd_batch (r[0], a[0], b[0], n, threads[j]);
+	check ("mpz_gcd_batch", threads[j], n);
+
+	for (i = 0; i < n; i++)
+	  {
+	    mpz_abs (b[i], b[i]);
+	    mpz_powm (ref[i], a[i], b[i], m[i]);
+	  }
+	mpz_powm_batch (r[0], a[0], b[0], m[0], n, threads[j]);
+	check ("mpz_powm_batch", threads[j], n);
+
+	/* In place, the results overwriting the first operands. */
+	for (i = 0; i < n; i++)
+	  {
+	    mpz_set (r[i], a[i]);
+	    mpz_mul (ref[i], a[i], b[i]);
+	  }
+	mpz_mul_batch (r[0], r[0], b[0], n, threads[j]);
+	check ("mpz_mul_batch in place", threads[j], n);
+      }
+
+  for (i = 0; i < N; i++)
+    {
+      mpz_clear (a[i]);
+      mpz_clear (b[i]);
+      mpz_clear (m[i]);
+      mpz_clear (r[i]);
+      mpz_clear (ref[i]);
+    }
+}
@@ -159,6 +159,48 @@ checkprimes (unsigned long p1, unsigned long p2, unsigned long p3)
 
 }
 
+/* Factorials and binomials large enough for the product tree to fork,
+   with several threads, against a plain running product and n! = bin(n,k)
+   k! (n-k)!.  */
+void
+check_large (unsigned long n, unsigned long k, int threads)
+{
+  mpz_t  f, want, b, t;
+  unsigned long  i;
+
+  mpz_init (f);
+  mpz_init_set_ui (want, 1);
+  mpz_init (b);
+  mpz_init (t);
+
+  mini_gmp_set_threads (threads);
+  mpz_fac_ui (f, n);
+  for (i = 2; i <= n; i++)
+    mpz_mul_ui (want, want, i);
+  if (mpz_cmp (f, want) != 0)
+    {
+      printf ("mpz_fac_ui(%lu) wrong with %d threads\n", n, threads);
+      abort ();
+    }
+
+  mpz_bin_uiui (b, n, k);
+  mpz_fac_ui (t, k);
+  mpz_mul (b, b, t);
+  mpz_fac_ui (t, n - k);
+  mpz_mul (b, b, t);
+  if (mpz_cmp (b, want) != 0)
+    {
+      printf ("mpz_bin_uiui(%lu, %lu) wrong with %d threads\n", n, k, threads);
+      abort ();
+    }
+  mini_gmp_set_threads (1);
+
+  mpz_clear (f);
+  mpz_clear (want);
+  mpz_clear (b);
+  mpz_clear (t);
+}
+
 void
 testmain (int argc, char *argv[])
 {
@@ -172,4 +214,6 @@ testmain (int argc, char *argv[])
   checkprimes(1009, 733, 277);
   fac_smallexaustive (limit);
   bin_smallexaustive (limit);
+  check_large (20000, 7000, 1);
+  check_large (20000, 13001, 4);
 }
@@ -0,0 +1,239 @@
+/* Tests the runtime-dispatched mpn kernels (mpn_popcount, mpn_hamdist,
+   mpn_and_n, mpn_ior_n, mpn_xor_n, mpn_com, mpn_zero_p, the carry-save
+   mpn_add_n / mpn_sub_n, and mpn_lshift / mpn_rshift with their allowed
+   overlaps) at every SIMD level available on the host, against plain
+   reference loops, for sizes around the vector widths and unaligned
+   operands.  */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "testutils.h"
+
+#define MAXN 70
+#define COUNT 200
+
+static mp_limb_t state = 0x9e3779b97f4a7c15ULL;
+
+static mp_limb_t
+random_limb (void)
+{
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+static mp_bitcnt_t
+ref_popcount (const mp_limb_t *p, mp_size_t n)
+{
+  mp_bitcnt_t c = 0;
+  mp_size_t i;
+  unsigned b;
+  for (i = 0; i < n; i++)
+    for (b = 0; b < 64; b++)
+      c += (p[i] >> b) & 1;
+  return c;
+}
+
+/* Limbs of all ones or zeros make carries and borrows ripple across
+   lanes and vectors. */
+static mp_limb_t
+carry_limb (void)
+{
+  const mp_limb_t x = random_limb ();
+  switch (x % 4)
+    {
+    case 0:
+      return ~(mp_limb_t) 0;
+    case 1:
+      return 0;
+    default:
+      return x;
+    }
+}
+
+static mp_limb_t
+ref_add_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+{
+  mp_limb_t cy = 0;
+  mp_size_t i;
+  for (i = 0; i < n; i++)
+    {
+      const mp_limb_t s = ap[i] + bp[i];
+      rp[i] = s + cy;
+      cy = (s < ap[i]) | (rp[i] < s);
+    }
+  return cy;
+}
+
+static mp_limb_t
+ref_sub_n (mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n)
+{
+  mp_limb_t cy = 0;
+  mp_size_t i;
+  for (i = 0; i < n; i++)
+    {
+      const mp_limb_t d = ap[i] - bp[i];
+      rp[i] = d - cy;
+      cy = (ap[i] < bp[i]) | (d < cy);
+    }
+  return cy;
+}
+
+static mp_limb_t
+ref_lshift (mp_ptr rp, mp_srcptr up, mp_size_t n, unsigned cnt)
+{
+  mp_size_t i;
+  for (i = 0; i < n; i++)
+    rp[i] = up[i] << cnt | (i > 0 ? up[i - 1] >> (64 - cnt) : 0);
+  return up[n - 1] >> (64 - cnt);
+}
+
+static mp_limb_t
+ref_rshift (mp_ptr rp, mp_srcptr up, mp_size_t n, unsigned cnt)
+{
+  mp_size_t i;
+  for (i = 0; i < n; i++)
+    rp[i] = up[i] >> cnt | (i < n - 1 ? up[i + 1] << (64 - cnt) : 0);
+  return up[0] << (64 - cnt);
+}
+
+static void
+check (const char *level, const char *op, mp_size_t n, int ok)
+{
+  if (!ok)
+    {
+      fprintf (stderr, "%s failed at level %s, n = %d\n", op, level, (int) n);
+      abort ();
+    }
+}
+
+static void
+check_level (const char *level)
+{
+  mp_limb_t a[MAXN + 1], b[MAXN + 1], r[MAXN + 2], x[MAXN + 1];
+  unsigned i;
+  mp_size_t n, k;
+
+  for (i = 0; i < COUNT; i++)
+    for (n = 0; n <= MAXN; n++)
+      {
+	/* Odd offsets make the operands unaligned for the vector loads. */
+	mp_limb_t *ap = a + (i & 1), *bp = b + ((i >> 1) & 1), *rp = r + 1;
+
+	for (k = 0; k <= MAXN; k++)
+	  {
+	    a[k] = random_limb ();
+	    b[k] = random_limb ();
+	  }
+	if (i % 8 == 3)
+	  for (k = 0; k < n; k++)
+	    ap[k] = 0;
+
+	check (level, "mpn_popcount", n, mpn_popcount (ap, n) == ref_popcount (ap, n));
+	for (k = 0; k < n; k++)
+	  x[k] = ap[k] ^ bp[k];
+	check (level, "mpn_hamdist", n, mpn_hamdist (ap, bp, n) == ref_popcount (x, n));
+
+	r[0] = r[n + 1] = 0x5a5a;
+	mpn_and_n (rp, ap, bp, n);
+	for (k = 0; k < n; k++)
+	  check (level, "mpn_and_n", n, rp[k] == (ap[k] & bp[k]));
+	mpn_ior_n (rp, ap, bp, n);
+	for (k = 0; k < n; k++)
+	  check (level, "mpn_ior_n", n, rp[k] == (ap[k] | bp[k]));
+	mpn_xor_n (rp, ap, bp, n);
+	for (k = 0; k < n; k++)
+	  check (level, "mpn_xor_n", n, rp[k] == (ap[k] ^ bp[k]));
+	mpn_com (rp, ap, n);
+	for (k = 0; k < n; k++)
+	  check (level, "mpn_com", n, rp[k] == ~ap[k]);
+	check (level, "mpn_and_n/mpn_com bounds", n, r[0] == 0x5a5a && r[n + 1] == 0x5a5a);
+
+	/* A single set bit anywhere must be found. */
+	mpn_zero (rp, n);
+	check (level, "mpn_zero_p", n, mpn_zero_p (rp, n));
+	if (n > 0)
+	  {
+	    k = (mp_size_t) (random_limb () % (mp_limb_t) n);
+	    rp[k] = (mp_limb_t) 1 << (random_limb () % 64);
+	    check (level, "mpn_zero_p", n, !mpn_zero_p (rp, n));
+	  }
+
+	for (k = 0; k < n; k++)
+	  {
+	    ap[k] = carry_limb ();
+	    bp[k] = i & 4 ? ~ap[k] : carry_limb ();
+	  }
+	if (n > 0 && (i & 4))
+	  /* A carry generated in the low limb runs through all the others. */
+	  bp[0] = carry_limb () | 1;
+	check (level, "mpn_add_n", n,
+	       mpn_add_n (rp, ap, bp, n) == ref_add_n (x, ap, bp, n)
+	       && mpn_cmp (rp, x, n) == 0);
+	check (level, "mpn_sub_n", n,
+	       mpn_sub_n (rp, ap, bp, n) == ref_sub_n (x, ap, bp, n)
+	       && mpn_cmp (rp, x, n) == 0);
+	/* In place. */
+	mpn_copyi (rp, ap, n);
+	check (level, "mpn_add_n in place", n,
+	       mpn_add_n (rp, rp, bp, n) == ref_add_n (x, ap, bp, n)
+	       && mpn_cmp (rp, x, n) == 0);
+
+	if (n > 0)
+	  {
+	    const unsigned cnt = 1 + (unsigned) (random_limb () % 63);
+	    mp_limb_t cy;
+
+	    cy = ref_lshift (x, ap, n, cnt);
+	    check (level, "mpn_lshift", n,
+		   mpn_lshift (rp, ap, n, cnt) == cy && mpn_cmp (rp, x, n) == 0);
+	    /* In place, and with rp = up + 1. */
+	    mpn_copyi (rp, ap, n);
+	    check (level, "mpn_lshift in place", n,
+		   mpn_lshift (rp, rp, n, cnt) == cy && mpn_cmp (rp, x, n) == 0);
+	    mpn_copyi (r, ap, n);
+	    check (level, "mpn_lshift overlapping", n,
+		   mpn_lshift (r + 1, r, n, cnt) == cy && mpn_cmp (r + 1, x, n) == 0);
+
+	    cy = ref_rshift (x, ap, n, cnt);
+	    check (level, "mpn_rshift", n,
+		   mpn_rshift (rp, ap, n, cnt) == cy && mpn_cmp (rp, x, n) == 0);
+	    mpn_copyi (rp, ap, n);
+	    check (level, "mpn_rshift in place", n,
+		   mpn_rshift (rp, rp, n, cnt) == cy && mpn_cmp (rp, x, n) == 0);
+	    mpn_copyi (r + 1, ap, n);
+	    check (level, "mpn_rshift overlapping", n,
+		   mpn_rshift (r, r + 1, n, cnt) == cy && mpn_cmp (r, x, n) == 0);
+	  }
+      }
+}
+
+void
+testmain (int argc, char **argv)
+{
+  static const char *const levels[] = { "scalar", "xsimd", "avx2", "avx512" };
+  unsigned i;
+
+  if (mini_gmp_set_simd_level ("bogus") != -1)
+    {
+      fprintf (stderr, "mini_gmp_set_simd_level accepted an unknown level\n");
+      abort ();
+    }
+  if (mini_gmp_set_simd_level ("scalar") != 1
+      || strcmp (mini_gmp_simd_level (), "scalar") != 0)
+    {
+      fprintf (stderr, "mini_gmp_set_simd_level failed to select scalar\n");
+      abort ();
+    }
+
+  for (i = 0; i < sizeof (levels) / sizeof (levels[0]); i++)
+    {
+      /* Levels the host or build lacks fall back to a lower one, which is
+	 then tested again; that is harmless. */
+      mini_gmp_set_simd_level (levels[i]);
+      check_level (mini_gmp_simd_level ());
+    }
+}
@@ -0,0 +1,154 @@
+/* Tests mpn_mul, mpn_sqr and mpn_montmul at every SIMD level available on
+   the host (the AVX-512 level uses the IFMA kernels for 12 to 64 limbs when
+   the CPU has them): products against the scalar level, Montgomery
+   products against mpz arithmetic.  */
+
+#include <limits.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "testutils.h"
+
+#define GMP_LIMB_BITS (sizeof(mp_limb_t) * CHAR_BIT)
+#define MAXN 70
+#define COUNT 300
+
+/* The n low limbs of |z|, zero-extended. */
+static void
+get_limbs (mp_ptr rp, const mpz_t z, mp_size_t n)
+{
+  const mp_size_t zn = mpz_size (z);
+  mpn_zero (rp, n);
+  if (zn > 0)
+    mpn_copyi (rp, mpz_limbs_read (z), zn < n ? zn : n);
+}
+
+static void
+random_limbs (mp_ptr rp, mp_size_t n, mpz_t t)
+{
+  /* Long runs of zero and one bits stress the carries. */
+  mini_rrandomb (t, n * GMP_LIMB_BITS);
+  get_limbs (rp, t, n);
+}
+
+static void
+check_mul (const char *level)
+{
+  mp_limb_t a[MAXN], b[MAXN], r[2 * MAXN], ref[2 * MAXN];
+  mpz_t t;
+  unsigned i;
+
+  mpz_init (t);
+  for (i = 0; i < COUNT; i++)
+    {
+      mp_size_t an, bn;
+      mini_urandomb (t, 16);
+      an = 1 + (mp_size_t) (mpz_get_ui (t) % MAXN);
+      mini_urandomb (t, 16);
+      bn = 1 + (mp_size_t) (mpz_get_ui (t) % an);
+      random_limbs (a, an, t);
+      random_limbs (b, bn, t);
+
+      mini_gmp_set_simd_level ("scalar");
+      mpn_mul (ref, a, an, b, bn);
+      mini_gmp_set_simd_level (level);
+      mpn_mul (r, a, an, b, bn);
+      if (mpn_cmp (r, ref, an + bn))
+	{
+	  fprintf (stderr, "mpn_mul failed at level %s, an = %d, bn = %d\n",
+		   level, (int) an, (int) bn);
+	  abort ();
+	}
+
+      mini_gmp_set_simd_level ("scalar");
+      mpn_sqr (ref, a, an);
+      mini_gmp_set_simd_level (level);
+      mpn_sqr (r, a, an);
+      if (mpn_cmp (r, ref, 2 * an))
+	{
+	  fprintf (stderr, "mpn_sqr failed at level %s, n = %d\n", level, (int) an);
+	  abort ();
+	}
+    }
+  mpz_clear (t);
+}
+
+static void
+check_montmul (const char *level)
+{
+  mp_limb_t a[MAXN], b[MAXN], m[MAXN], r[MAXN];
+  mpz_t t, za, zb, zm, zr, ref;
+  unsigned i;
+
+  mpz_init (t);
+  mpz_init (za);
+  mpz_init (zb);
+  mpz_init (zm);
+  mpz_init (zr);
+  mpz_init (ref);
+
+  for (i = 0; i < COUNT; i++)
+    {
+      mp_size_t n;
+      mini_urandomb (t, 16);
+      n = 1 + (mp_size_t) (mpz_get_ui (t) % MAXN);
+
+      /* Odd modulus of exactly n limbs; a, b < m, including m - 1. */
+      mini_rrandomb (zm, n * GMP_LIMB_BITS);
+      mpz_setbit (zm, n * GMP_LIMB_BITS - 1);
+      mpz_setbit (zm, 0);
+      mini_rrandomb (za, n * GMP_LIMB_BITS);
+      mpz_mod (za, za, zm);
+      if (i % 8 == 5)
+	mpz_sub_ui (zb, zm, 1);
+      else
+	{
+	  mini_rrandomb (zb, n * GMP_LIMB_BITS);
+	  mpz_mod (zb, zb, zm);
+	}
+      get_limbs (m, zm, n);
+      get_limbs (a, za, n);
+      get_limbs (b, zb, n);
+
+      mini_gmp_set_simd_level (level);
+      mpn_montmul (r, a, b, m, n);
+      /* In place, too. */
+      mpn_montmul (a, a, b, m, n);
+
+      mpn_copyi (mpz_limbs_write (zr, n), r, n);
+      mpz_limbs_finish (zr, n);
+      mpz_mul_2exp (t, zr, n * GMP_LIMB_BITS);
+      mpz_mul (ref, za, zb);
+      mpz_sub (t, t, ref);
+      if (mpz_cmp (zr, zm) >= 0 || !mpz_divisible_p (t, zm)
+	  || mpn_cmp (a, r, n) != 0)
+	{
+	  fprintf (stderr, "mpn_montmul failed at level %s, n = %d\n", level, (int) n);
+	  dump ("m", zm);
+	  dump ("a", za);
+	  dump ("b", zb);
+	  dump ("r", zr);
+	  abort ();
+	}
+    }
+
+  mpz_clear (t);
+  mpz_clear (za);
+  mpz_clear (zb);
+  mpz_clear (zm);
+  mpz_clear (zr);
+  mpz_clear (ref);
+}
+
+void
+testmain (int argc, char **argv)
+{
+  static const char *const levels[] = { "scalar", "xsimd", "avx2", "avx512" };
+  unsigned i;
+
+  for (i = 0; i < sizeof (levels) / sizeof (levels[0]); i++)
+    {
+      check_mul (levels[i]);
+      check_montmul (levels[i]);
+    }
+}
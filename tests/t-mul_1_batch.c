@@ -0,0 +1,119 @@
+/* Tests mpn_mul_1_batch and mpn_addmul_1_batch at every SIMD level
+   available on the host against mpn_mul_1 / mpn_addmul_1 applied to each
+   operand, for lane counts around the vector widths and extreme limbs.  */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "testutils.h"
+
+#define MAXN 9
+#define MAXCOUNT 21
+#define COUNT 300
+
+static mp_limb_t state = 0x2545f4914f6cdd1dULL;
+
+static mp_limb_t
+random_limb (void)
+{
+  mp_limb_t x;
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  x = state;
+  /* Favour all-ones and zero limbs, where the carries are at their
+     extremes. */
+  switch (x & 7)
+    {
+    case 0:
+      return ~(mp_limb_t) 0;
+    case 1:
+      return 0;
+    default:
+      return x;
+    }
+}
+
+static void
+check_level (const char *level)
+{
+  mp_limb_t u[MAXN * MAXCOUNT], r[MAXN * MAXCOUNT], v[MAXCOUNT], c[MAXCOUNT];
+  mp_limb_t er[MAXN * MAXCOUNT], ec[MAXCOUNT], op[MAXN], res[MAXN];
+  unsigned i;
+  mp_size_t n, count, k, j;
+
+  for (i = 0; i < COUNT; i++)
+    for (count = 0; count <= MAXCOUNT; count++)
+      {
+	const int add = i & 1;
+
+	n = 1 + (mp_size_t) (random_limb () % MAXN);
+	for (k = 0; k < n * count; k++)
+	  {
+	    u[k] = random_limb ();
+	    r[k] = random_limb ();
+	  }
+	for (k = 0; k < count; k++)
+	  v[k] = random_limb ();
+
+	for (k = 0; k < count; k++)
+	  {
+	    for (j = 0; j < n; j++)
+	      {
+		op[j] = u[j * count + k];
+		res[j] = r[j * count + k];
+	      }
+	    ec[k] = add ? mpn_addmul_1 (res, op, n, v[k]) : mpn_mul_1 (res, op, n, v[k]);
+	    for (j = 0; j < n; j++)
+	      er[j * count + k] = res[j];
+	  }
+
+	if (add)
+	  mpn_addmul_1_batch (r, u, n, v, c, count);
+	else
+	  mpn_mul_1_batch (r, u, n, v, c, count);
+
+	for (k = 0; k < count; k++)
+	  {
+	    int ok = c[k] == ec[k];
+	    for (j = 0; j < n; j++)
+	      ok &= r[j * count + k] == er[j * count + k];
+	    if (!ok)
+	      {
+		fprintf (stderr, "%s failed at level %s, n = %d, count = %d, lane %d\n",
+			 add ? "mpn_addmul_1_batch" : "mpn_mul_1_batch", level,
+			 (int) n, (int) count, (int) k);
+		abort ();
+	      }
+	  }
+      }
+
+  /* In place: rp == up. */
+  count = 13;
+  n = 5;
+  for (k = 0; k < n * count; k++)
+    u[k] = r[k] = random_limb ();
+  for (k = 0; k < count; k++)
+    v[k] = random_limb ();
+  mpn_mul_1_batch (er, u, n, v, ec, count);
+  mpn_mul_1_batch (r, r, n, v, c, count);
+  for (k = 0; k < n * count; k++)
+    if (r[k] != er[k] || (k < count && c[k] != ec[k]))
+      {
+	fprintf (stderr, "in-place mpn_mul_1_batch failed at level %s\n", level);
+	abort ();
+      }
+}
+
+void
+testmain (int argc, char **argv)
+{
+  static const char *const levels[] = { "scalar", "xsimd", "avx2", "avx512" };
+  unsigned i;
+
+  for (i = 0; i < sizeof (levels) / sizeof (levels[0]); i++)
+    {
+      mini_gmp_set_simd_level (levels[i]);
+      check_level (mini_gmp_simd_level ());
+    }
+}
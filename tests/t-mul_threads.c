@@ -0,0 +1,97 @@
+/* Tests mpn_mul_threads / mpz_mul_threads, and mpz_mul under a global
+   thread budget, against the serial product, for operands large enough to
+   be split into blocks on the task pool, uneven sizes and in-place use.  */
+
+#include <limits.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "testutils.h"
+
+#define GMP_LIMB_BITS (sizeof(mp_limb_t) * CHAR_BIT)
+#define MAXLIMBS 2600
+#define COUNT 24
+
+static void
+check (const char *op, int threads, const mpz_t a, const mpz_t b,
+       const mpz_t r, const mpz_t ref)
+{
+  if (mpz_cmp (r, ref))
+    {
+      fprintf (stderr, "%s failed with %d threads, sizes %d x %d\n", op,
+	       threads, (int) mpz_size (a), (int) mpz_size (b));
+      abort ();
+    }
+}
+
+void
+testmain (int argc, char **argv)
+{
+  static const int threads[] = { 2, 3, 8 };
+  mpz_t a, b, r, ref, t;
+  mp_ptr rp;
+  unsigned i, j;
+
+  mpz_init (a);
+  mpz_init (b);
+  mpz_init (r);
+  mpz_init (ref);
+  mpz_init (t);
+
+  if (mini_gmp_threads () < 1)
+    {
+      fprintf (stderr, "mini_gmp_threads returned %d\n", mini_gmp_threads ());
+      abort ();
+    }
+
+  for (i = 0; i < COUNT; i++)
+    {
+      mp_size_t an, bn;
+      mini_urandomb (t, 16);
+      an = 512 + (mp_size_t) (mpz_get_ui (t) % (MAXLIMBS - 512));
+      mini_urandomb (t, 16);
+      bn = i % 4 == 0 ? 1 + (mp_size_t) (mpz_get_ui (t) % 64)
+	: 512 + (mp_size_t) (mpz_get_ui (t) % (an - 511));
+      /* Long runs of ones make the carries of the recombination ripple. */
+      mini_rrandomb (a, an * GMP_LIMB_BITS);
+      mini_rrandomb (b, bn * GMP_LIMB_BITS);
+      if (i & 1)
+	mpz_neg (b, b);
+
+      mini_gmp_set_threads (1);
+      mpz_mul (ref, a, b);
+
+      for (j = 0; j < sizeof (threads) / sizeof (threads[0]); j++)
+	{
+	  mpz_mul_threads (r, a, b, threads[j]);
+	  check ("mpz_mul_threads", threads[j], a, b, r, ref);
+	  mpz_mul_threads (r, b, a, threads[j]);
+	  check ("mpz_mul_threads (swapped)", threads[j], a, b, r, ref);
+	}
+
+      mini_gmp_set_threads (4);
+      mpz_mul (r, a, b);
+      check ("mpz_mul", 4, a, b, r, ref);
+      /* In place. */
+      mpz_set (r, a);
+      mpz_mul (r, r, b);
+      check ("mpz_mul in place", 4, a, b, r, ref);
+
+      if (mpz_size (a) >= mpz_size (b) && mpz_size (b) > 0)
+	{
+	  const mp_size_t un = mpz_size (a), vn = mpz_size (b);
+	  rp = mpz_limbs_write (r, un + vn);
+	  mpn_mul_threads (rp, mpz_limbs_read (a), un, mpz_limbs_read (b), vn, 5);
+	  mpz_limbs_finish (r, un + vn);
+	  mpz_abs (t, ref);
+	  check ("mpn_mul_threads", 5, a, b, r, t);
+	}
+    }
+  mini_gmp_set_threads (1);
+
+  mpz_clear (a);
+  mpz_clear (b);
+  mpz_clear (r);
+  mpz_clear (ref);
+  mpz_clear (t);
+}
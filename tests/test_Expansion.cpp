@@ -0,0 +1,149 @@
+// test_Expansion.cpp
+#include "../Expansion.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+
+namespace {
+
+std::mt19937_64 rng(2024);
+
+// Random double with a random exponent in [-60, 60] and random sign.
+double random_double() {
+    std::uniform_real_distribution<double> mant(1.0, 2.0);
+    std::uniform_int_distribution<int> exp(-60, 60);
+    const double x = std::ldexp(mant(rng), exp(rng));
+    return (rng() & 1U) != 0U ? -x : x;
+}
+
+// Exponent of the highest and lowest set bit of a nonzero double.
+int high_bit(double x) {
+    int e = 0;
+    std::frexp(x, &e);
+    return e - 1;
+}
+
+int low_bit(double x) {
+    int e = 0;
+    const double m = std::frexp(std::fabs(x), &e);
+    uint64_t bits = static_cast<uint64_t>(std::ldexp(m, 53));
+    int low = e - 53;
+    while ((bits & 1U) == 0U) {
+        bits >>= 1;
+        ++low;
+    }
+    return low;
+}
+
+// Terms are nonzero (unless the expansion is the single term 0), sorted by
+// increasing magnitude and nonoverlapping.
+template<int N>
+void check_invariants(const Expansion<N>& e) {
+    assert(e.size() >= 1 && e.size() <= N);
+    if (e.size() == 1) {
+        return;
+    }
+    for (int i = 0; i < e.size(); ++i) {
+        assert(e[i] != 0.0);
+    }
+    for (int i = 0; i + 1 < e.size(); ++i) {
+        assert(high_bit(e[i]) < low_bit(e[i + 1]));
+    }
+}
+
+void test_two_term_constructors() {
+    for (int k = 0; k < 1000; ++k) {
+        const double a = random_double();
+        const double b = random_double();
+        const Expansion<2> s = Expansion<2>::from_sum(a, b);
+        const Expansion<2> d = Expansion<2>::from_diff(a, b);
+        const Expansion<2> p = Expansion<2>::from_product(a, b);
+        check_invariants(s);
+        check_invariants(d);
+        check_invariants(p);
+        assert(s.to_MiniMPF() == MiniMPF(a) + MiniMPF(b));
+        assert(d.to_MiniMPF() == MiniMPF(a) - MiniMPF(b));
+        assert(p.to_MiniMPF() == MiniMPF(a) * MiniMPF(b));
+    }
+    assert(Expansion<2>::from_diff(1.5, 1.5).sign() == 0);
+    assert(Expansion<2>::from_sum(1.0, 1e-30).size() == 2);
+
+    std::cout << "Two-term constructor tests passed\n";
+}
+
+void test_operations_against_minimpf() {
+    for (int k = 0; k < 500; ++k) {
+        const double a = random_double(), b = random_double(), c = random_double(), d = random_double();
+        const Expansion<2> x = Expansion<2>::from_product(a, b);
+        const Expansion<2> y = Expansion<2>::from_diff(c, d);
+        const MiniMPF mx = MiniMPF(a) * MiniMPF(b);
+        const MiniMPF my = MiniMPF(c) - MiniMPF(d);
+
+        const Expansion<4> s = sum(x, y);
+        check_invariants(s);
+        assert(s.to_MiniMPF() == mx + my);
+
+        const Expansion<4> diff = difference(x, y);
+        check_invariants(diff);
+        assert(diff.to_MiniMPF() == mx - my);
+
+        const Expansion<3> g = grow(x, c);
+        check_invariants(g);
+        assert(g.to_MiniMPF() == mx + MiniMPF(c));
+
+        const Expansion<4> sc = scale(y, a);
+        check_invariants(sc);
+        assert(sc.to_MiniMPF() == my * MiniMPF(a));
+
+        const Expansion<8> p = product(x, y);
+        check_invariants(p);
+        assert(p.to_MiniMPF() == mx * my);
+
+        // Longer chain with cancellation: p * p - p * p' where p' = p + tiny
+        const Expansion<9> q = grow(p, std::ldexp(a, -200));
+        auto r = difference(product(p, p), product(p, q));
+        static_assert(decltype(r)::capacity() == 128 + 144, "capacity is a static bound");
+        check_invariants(r);
+        const MiniMPF mp = p.to_MiniMPF();
+        const MiniMPF expected = mp * mp - mp * q.to_MiniMPF();
+        assert(r.to_MiniMPF() == expected);
+        assert(r.sign() == expected.Sign());
+
+        const int before = r.size();
+        r.compress();
+        assert(r.size() <= before);
+        assert(r.to_MiniMPF() == expected);
+        assert(r.sign() == expected.Sign());
+    }
+
+    std::cout << "Operations vs MiniMPF tests passed\n";
+}
+
+void test_sign_and_estimate() {
+    Expansion<2> one(1.0);
+    const Expansion<3> e = grow(one, -1e-300);
+    assert(e.sign() == 1);
+    assert(e.estimate() == 1.0);
+
+    const auto z = difference(one, grow(Expansion<2>(0.5), 0.5));
+    assert(z.sign() == 0);
+    assert(z.size() == 1 && z[0] == 0.0);
+    assert(z.to_MiniMPF().IsZero());
+    assert(Expansion<1>().to_MiniMPF().IsZero());
+
+    std::cout << "Sign/estimate tests passed\n";
+}
+
+} // namespace
+
+int main() {
+    test_two_term_constructors();
+    test_operations_against_minimpf();
+    test_sign_and_estimate();
+
+    std::cout << "\nAll Expansion tests passed!\n";
+    return 0;
+}
@@ -4,6 +4,9 @@
 #include <cmath>
 #include <functional>
 #include <iostream>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
 
 namespace {
 
@@ -16,17 +19,17 @@ void test_default_and_sign() {
     assert(z.IsZero());
     assert(!z.IsPositive());
     assert(!z.IsNegative());
-    assert(z.Sign() == ZERO);
+    assert(z.Sign() == 0);
 
     MiniMPF p(MiniMPZ(7L), 0);
     assert(p.IsPositive());
     assert(!p.IsNegative());
-    assert(p.Sign() == POSITIVE);
+    assert(p.Sign() == 1);
 
     MiniMPF n(MiniMPZ(-11L), 0);
     assert(!n.IsPositive());
     assert(n.IsNegative());
-    assert(n.Sign() == NEGATIVE);
+    assert(n.Sign() == -1);
 
     n.FlipSign();
     assert(n.IsPositive());
@@ -86,6 +89,21 @@ void test_comparison() {
     assert(a == c);
     assert(a != b);
 
+    // Different exponents and multi-limb mantissas: compare must agree with
+    // the sign of the exact difference.
+    const MiniMPZ big("340282366920938463463374607431768211455");  // 2^128 - 1
+    const MiniMPF values[] = {
+        MiniMPF(big, 0), MiniMPF(big, 64), MiniMPF(big + MiniMPZ(2L), 0),
+        MiniMPF(big - MiniMPZ(2L), 1), MiniMPF(MiniMPZ(1L), 128), MiniMPF(MiniMPZ(1L), 127),
+        MiniMPF(MiniMPZ(3L), 126), MiniMPF(-big, 3), MiniMPF(-big, -70), MiniMPF(0.75),
+        MiniMPF(-0.75), MiniMPF(1e-30), MiniMPF(), MiniMPF(MiniMPZ(5L), -200)
+    };
+    for (const MiniMPF& x : values) {
+        for (const MiniMPF& y : values) {
+            assert(x.compare(y) == (x - y).Sign());
+        }
+    }
+
     std::cout << "Comparison tests passed\n";
 }
 
@@ -211,6 +229,20 @@ void test_hash_and_visu() {
     std::hash<MiniMPF> hasher;
     assert(hasher(a) == ha);
 
+    // Equal values hash the same even when one mantissa is not normalized:
+    // MiniMPF(1.0) stores 2^53 * 2^-53.
+    assert(MiniMPF(1.0).hash() == MiniMPF(MiniMPZ(1L), 0).hash());
+    assert(MiniMPF(-0.375).hash() == MiniMPF(MiniMPZ(-3L), -3).hash());
+    assert(MiniMPF(1.0).hash() != MiniMPF(-1.0).hash());
+    assert(MiniMPF(1.0).hash() != MiniMPF(2.0).hash());
+
+    std::unordered_map<MiniMPF, int> counts;
+    for (int i = 0; i < 100; ++i) {
+        ++counts[MiniMPF(static_cast<double>(i % 10) * 0.5)];
+    }
+    assert(counts.size() == 10);
+    assert(counts[MiniMPF(MiniMPZ(9L), -1)] == 10);
+
     std::cout << "Hash/Visu tests passed\n";
 }
 
@@ -230,6 +262,227 @@ void test_zero_stability() {
     std::cout << "Zero stability tests passed\n";
 }
 
+void test_round_to_precision() {
+    const MiniMPF eleven(MiniMPZ(11L), 0);  // 0b1011
+    MiniMPF r = eleven;
+    r.round_to_precision(3);
+    assert(r == MiniMPF(MiniMPZ(12L), 0));
+    r = eleven;
+    r.round_to_precision(3, MiniMPFRounding::TowardZero);
+    assert(r == MiniMPF(MiniMPZ(10L), 0));
+    r = eleven;
+    r.round_to_precision(3, MiniMPFRounding::Downward);
+    assert(r == MiniMPF(MiniMPZ(10L), 0));
+    r = -eleven;
+    r.round_to_precision(3, MiniMPFRounding::Upward);
+    assert(r == MiniMPF(MiniMPZ(-10L), 0));
+    r = -eleven;
+    r.round_to_precision(3, MiniMPFRounding::Downward);
+    assert(r == MiniMPF(MiniMPZ(-12L), 0));
+
+    // Ties to even: 0b1010 -> 0b1000 (3 bits would keep it, 2 bits is a tie)
+    r = MiniMPF(MiniMPZ(10L), 0);
+    r.round_to_precision(2);
+    assert(r == MiniMPF(MiniMPZ(8L), 0));
+
+    bool thrown = false;
+    try {
+        r.round_to_precision(0);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << "Round-to-precision tests passed\n";
+}
+
+void test_div_and_sqrt() {
+    // At 53 bits, round-to-nearest must agree with IEEE double division and sqrt.
+    const double values[] = { 1.0, 3.0, 7.0, 0.1, 1e10, 123456.789, 2.0, 1e-7, 5e300 };
+    for (double x : values) {
+        for (double y : values) {
+            assert(div(MiniMPF(x), MiniMPF(y), 53) == MiniMPF(x / y));
+            assert(div(MiniMPF(-x), MiniMPF(y), 53) == MiniMPF(-x / y));
+        }
+        assert(sqrt(MiniMPF(x), 53) == MiniMPF(std::sqrt(x)));
+    }
+
+    // Directed results bracket the exact value and are one ulp apart at most.
+    const MiniMPF a(MiniMPZ("123456789012345678901234567891"), -40);
+    const MiniMPF b(MiniMPZ("-987654321987654321"), 7);
+    for (int precision : { 1, 8, 64, 200 }) {
+        const MiniMPF q_down = div(a, b, precision, MiniMPFRounding::Downward);
+        const MiniMPF q_up = div(a, b, precision, MiniMPFRounding::Upward);
+        const MiniMPF q_zero = div(a, b, precision, MiniMPFRounding::TowardZero);
+        assert(q_down * b >= a);   // b < 0 flips the inequalities
+        assert(q_up * b <= a);
+        assert(q_down < q_up);
+        assert(q_zero == q_up);    // the quotient is negative
+        assert(static_cast<int>(mpz_sizeinbase(q_up.Mantisse().get_mpz(), 2)) <= precision);
+
+        const MiniMPF s_down = sqrt(a, precision, MiniMPFRounding::Downward);
+        const MiniMPF s_up = sqrt(a, precision, MiniMPFRounding::Upward);
+        assert(s_down * s_down <= a);
+        assert(s_up * s_up >= a);
+        assert(s_down < s_up);
+    }
+
+    // Exact results stay exact in every rounding mode.
+    const MiniMPF nine(MiniMPZ(9L), 6);
+    for (MiniMPFRounding mode : { MiniMPFRounding::ToNearest, MiniMPFRounding::TowardZero,
+                                  MiniMPFRounding::Upward, MiniMPFRounding::Downward }) {
+        assert(sqrt(nine, 4, mode) == MiniMPF(MiniMPZ(3L), 3));
+        assert(div(nine, MiniMPF(MiniMPZ(-3L), 1), 4, mode) == MiniMPF(MiniMPZ(-3L), 5));
+    }
+    assert(div(MiniMPF(), nine, 10).IsZero());
+    assert(sqrt(MiniMPF(), 10).IsZero());
+
+    bool thrown = false;
+    try {
+        div(nine, MiniMPF(), 10);
+    } catch (const std::domain_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+    thrown = false;
+    try {
+        sqrt(-nine, 10);
+    } catch (const std::domain_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << "Div/sqrt tests passed\n";
+}
+
+void test_dot_product() {
+    // Mixed signs, exponents far apart, multi-limb mantissas and zeros.
+    const MiniMPF a[] = {
+        MiniMPF(1.5), MiniMPF(-3.25e10), MiniMPF(MiniMPZ("-123456789012345678901234567890123"), -301),
+        MiniMPF(), MiniMPF(7e-200), MiniMPF(MiniMPZ("98765432109876543210987654321"), 77), MiniMPF(-0.1)
+    };
+    const MiniMPF b[] = {
+        MiniMPF(-2.0), MiniMPF(1e-12), MiniMPF(MiniMPZ("340282366920938463463374607431768211457"), 5),
+        MiniMPF(3.0), MiniMPF(-5e150), MiniMPF(MiniMPZ(-3L), -140), MiniMPF(0.1)
+    };
+    const size_t n = sizeof(a) / sizeof(a[0]);
+    for (size_t len = 0; len <= n; ++len) {
+        MiniMPF expected;
+        for (size_t i = 0; i < len; ++i) {
+            expected += a[i] * b[i];
+        }
+        assert(dot_product(a, b, len) == expected);
+    }
+
+    // Exact cancellation gives zero.
+    const MiniMPF c[] = { MiniMPF(0.75), MiniMPF(MiniMPZ("123456789012345678901234567890"), -3) };
+    const MiniMPF d[] = { MiniMPF(MiniMPZ("123456789012345678901234567890"), -3), MiniMPF(-0.75) };
+    const MiniMPF zero = dot_product(c, d, 2);
+    assert(zero.IsZero() && zero.Exponent() == 0);
+
+    // The std::array variants agree.
+    const std::array<MiniMPF, 4> x = {{ MiniMPF(1.25), MiniMPF(-2e20), MiniMPF(3e-20), MiniMPF(0.5) }};
+    const std::array<MiniMPF, 4> y = {{ MiniMPF(4.0), MiniMPF(1e-20), MiniMPF(-7e19), MiniMPF(0.5) }};
+    const MiniMPF reference = x[0] * y[0] + x[1] * y[1] + x[2] * y[2] + x[3] * y[3];
+    assert(dot_product_fused(x, y) == reference);
+    assert(dot_product_simd4(x, y) == reference);
+
+    // Later products with smaller and then larger exponents than the running
+    // sum: the accumulator must be realigned in both directions.
+    const std::array<MiniMPF, 3> p = {{ MiniMPF(1.0), MiniMPF(0.5), MiniMPF(MiniMPZ(3L), 40) }};
+    const std::array<MiniMPF, 3> q = {{ MiniMPF(3.0), MiniMPF(0.25), MiniMPF(-1.0) }};
+    const MiniMPF aligned = dot_product_fused(p, q);
+    assert(aligned == MiniMPF(3.125 - std::ldexp(3.0, 40)));
+
+    // Up to 16 double-derived terms, with product exponents spread around
+    // the 123-bit limit of the 256-bit fast path, and all-negative sums
+    // near the accumulator's capacity.
+    std::mt19937_64 rng(12345);
+    for (int trial = 0; trial < 2000; ++trial) {
+        const size_t len = 1 + static_cast<size_t>(rng() % 16);
+        const int spread = 100 + static_cast<int>(rng() % 50);
+        const bool same_sign = (trial % 4) == 0;
+        std::array<MiniMPF, 16> u, v;
+        MiniMPF expected;
+        for (size_t i = 0; i < len; ++i) {
+            const double mu = std::ldexp(static_cast<double>(rng() >> 11), -53) + 1.0;
+            const double mv = std::ldexp(static_cast<double>(rng() >> 11), -53) + 1.0;
+            const int e = static_cast<int>(rng() % static_cast<uint64_t>(spread + 1)) - spread / 2;
+            u[i] = MiniMPF(std::ldexp(same_sign || (rng() & 1) ? -mu : mu, e / 2));
+            v[i] = MiniMPF(std::ldexp(mv, e - e / 2));
+            expected += u[i] * v[i];
+        }
+        assert(dot_product(u.data(), v.data(), len) == expected);
+    }
+
+    std::cout << "Dot product tests passed\n";
+}
+
+void test_precision_limit() {
+    assert(MiniMPF::precision_limit().bits == 0);
+    const MiniMPF x(MiniMPZ("1234567890123456789"), -60);
+
+    // A long product chain keeps at most 64 bits under the limit.
+    {
+        const MiniMPFPrecisionScope limit(64);
+        MiniMPF p(1.0);
+        for (int i = 0; i < 50; ++i) {
+            p *= x;
+            p += x;
+            assert(mpz_sizeinbase(p.Mantisse().get_mpz(), 2) <= 64);
+        }
+        assert(MiniMPF::precision_limit().bits == 64);
+    }
+    assert(MiniMPF::precision_limit().bits == 0);
+
+    // Directed modes bracket the exact result.
+    const MiniMPF y(MiniMPZ("-98765432109876543210987"), 3);
+    const MiniMPF exact_sum = x + y, exact_product = x * y;
+    const MiniMPF exact_fma = fma(x, y, x);
+    MiniMPF down_sum, up_sum, down_product, up_product, down_fma, up_fma;
+    {
+        const MiniMPFPrecisionScope limit(20, MiniMPFRounding::Downward);
+        down_sum = x + y;
+        down_product = x * y;
+        down_fma = fma(x, y, x);
+    }
+    {
+        const MiniMPFPrecisionScope limit(20, MiniMPFRounding::Upward);
+        up_sum = x + y;
+        up_product = x * y;
+        up_fma = fma(x, y, x);
+    }
+    assert(down_sum < exact_sum && exact_sum < up_sum);
+    assert(down_product < exact_product && exact_product < up_product);
+    assert(down_fma <= exact_fma && exact_fma <= up_fma);
+
+    // fma rounds once: the same as rounding the exact result.
+    MiniMPF rounded = exact_fma;
+    rounded.round_to_precision(20, MiniMPFRounding::Downward);
+    assert(down_fma == rounded);
+
+    // Scopes nest, and MiniMPFPrecisionScope(0) restores exact arithmetic.
+    {
+        const MiniMPFPrecisionScope outer(8);
+        {
+            const MiniMPFPrecisionScope inner(0);
+            assert(x * y == exact_product);
+        }
+        assert(MiniMPF::precision_limit().bits == 8);
+    }
+
+    bool thrown = false;
+    try {
+        MiniMPF::set_precision_limit(-1);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(MiniMPF::precision_limit().bits == 0);
+
+    std::cout << "Precision limit tests passed\n";
+}
+
 } // namespace
 
 int main() {
@@ -244,6 +497,10 @@ int main() {
     test_bounds_non_degenerate();
     test_hash_and_visu();
     test_zero_stability();
+    test_round_to_precision();
+    test_div_and_sqrt();
+    test_dot_product();
+    test_precision_limit();
 
     std::cout << "\nAll MiniMPF tests passed!\n";
     return 0;
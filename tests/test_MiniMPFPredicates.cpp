@@ -0,0 +1,243 @@
+// test_MiniMPFPredicates.cpp
+#include "../MiniMPFPredicates.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace mp = mini_gmp_plus_predicates;
+
+namespace {
+
+void test_known_configurations() {
+    const double a[2] = { 0.0, 0.0 }, b[2] = { 1.0, 0.0 }, c[2] = { 0.0, 1.0 };
+    const double inside[2] = { 0.25, 0.25 }, outside[2] = { 2.0, 2.0 }, on[2] = { 1.0, 1.0 };
+    assert(mp::orient2d(a, b, c) == 1);
+    assert(mp::orient2d(a, c, b) == -1);
+    assert(mp::orient2d(a, b, outside) == 1);
+    assert(mp::incircle(a, b, c, inside) == 1);
+    assert(mp::incircle(a, b, c, outside) == -1);
+    assert(mp::incircle(a, b, c, on) == 0);
+
+    const double p[3] = { 0.0, 0.0, 0.0 }, q[3] = { 1.0, 0.0, 0.0 }, r[3] = { 0.0, 1.0, 0.0 };
+    const double below[3] = { 0.0, 0.0, -1.0 }, above[3] = { 0.0, 0.0, 1.0 }, in_plane[3] = { 3.0, 5.0, 0.0 };
+    assert(mp::orient3d(p, q, r, below) == 1);
+    assert(mp::orient3d(p, q, r, above) == -1);
+    assert(mp::orient3d(p, q, r, in_plane) == 0);
+
+    // Sphere through p, q, r, below has center (0.5, 0.5, -0.5).
+    const double center[3] = { 0.5, 0.5, -0.5 }, far[3] = { 5.0, 5.0, 5.0 }, on_sphere[3] = { 1.0, 1.0, 0.0 };
+    assert(mp::insphere(p, q, r, below, center) == 1);
+    assert(mp::insphere(p, q, r, below, far) == -1);
+    assert(mp::insphere(p, q, r, below, on_sphere) == 0);
+
+    std::cout << "Known configuration tests passed\n";
+}
+
+void test_near_degenerate_orient2d() {
+    // Classic failure case of the naive double formula: points a few ulps
+    // around the line y = x, tested against (12, 12) and (24, 24).
+    const double b[2] = { 12.0, 12.0 }, c[2] = { 24.0, 24.0 };
+    int filtered = 0, total = 0;
+    for (int i = 0; i < 64; ++i) {
+        for (int j = 0; j < 64; ++j) {
+            const double a[2] = { 0.5 + i * std::ldexp(1.0, -53), 0.5 + j * std::ldexp(1.0, -53) };
+            const int exact = mp::orient2d_exact(a, b, c);
+            assert(mp::orient2d(a, b, c) == exact);
+            int sign = 0;
+            if (mp::orient2d_filter(a, b, c, sign)) {
+                assert(sign == exact);
+                ++filtered;
+            }
+            assert(mp::orient2d_expansion(a, b, c, sign) && sign == exact);
+            ++total;
+            // Exact answer: sign of (a.y - a.x) * 12
+            const double diff = a[1] - a[0];
+            assert(exact == (diff > 0) - (diff < 0));
+        }
+    }
+    assert(filtered < total);
+
+    std::cout << "Near-degenerate orient2d tests passed\n";
+}
+
+void test_expansion_stage() {
+    std::mt19937_64 rng(99);
+    std::uniform_real_distribution<double> coord(-1.0, 1.0);
+    for (int k = 0; k < 2000; ++k) {
+        double p[4][3];
+        for (auto& pt : p) {
+            for (double& x : pt) {
+                x = coord(rng);
+            }
+        }
+        // d close to the plane through a, b, c: d = a + s (b - a) + t (c - a),
+        // rounded, then nudged by a few ulps.
+        const double s = coord(rng), t = coord(rng);
+        for (int j = 0; j < 3; ++j) {
+            p[3][j] = p[0][j] + s * (p[1][j] - p[0][j]) + t * (p[2][j] - p[0][j]);
+            for (int n = k % 3; n > 0; --n) {
+                p[3][j] = std::nextafter(p[3][j], 2.0);
+            }
+        }
+        int sign = 0;
+        const bool certain = mp::orient3d_expansion(p[0], p[1], p[2], p[3], sign);
+        assert(certain);
+        (void) certain;
+        assert(sign == mp::orient3d_exact(p[0], p[1], p[2], p[3]));
+        assert(mp::orient3d(p[0], p[1], p[2], p[3]) == sign);
+    }
+
+    // Coordinates outside [2^-200, 2^200] are left to the MiniMPF stage.
+    const double a[2] = { 1e-250, 0.0 }, b[2] = { 1.0, 1.0 }, c[2] = { 2.0, 2.0 };
+    int sign = 0;
+    const bool certain = mp::orient2d_expansion(a, b, c, sign);
+    assert(!certain);
+    (void) certain;
+    assert(mp::orient2d(a, b, c) == mp::orient2d_exact(a, b, c));
+
+    std::cout << "Expansion stage tests passed\n";
+}
+
+void test_filter_agrees_with_exact() {
+    std::mt19937_64 rng(12345);
+    std::uniform_real_distribution<double> coord(-1.0, 1.0);
+    const int rounds = 20000;
+    int uncertain = 0;
+    for (int k = 0; k < rounds; ++k) {
+        double pts[5][3];
+        for (auto& pt : pts) {
+            for (double& x : pt) {
+                x = coord(rng);
+            }
+        }
+        // One in eight cases is made exactly degenerate: e = a, in plane, or cocircular.
+        if (k % 8 == 0) {
+            pts[4][0] = pts[0][0];
+            pts[4][1] = pts[0][1];
+            pts[4][2] = pts[0][2];
+        }
+
+        int s = 0;
+        if (mp::orient2d_filter(pts[0], pts[1], pts[2], s)) {
+            assert(s == mp::orient2d_exact(pts[0], pts[1], pts[2]));
+        } else {
+            ++uncertain;
+        }
+        if (mp::orient3d_filter(pts[0], pts[1], pts[2], pts[3], s)) {
+            assert(s == mp::orient3d_exact(pts[0], pts[1], pts[2], pts[3]));
+        } else {
+            ++uncertain;
+        }
+        if (mp::incircle_filter(pts[0], pts[1], pts[2], pts[4], s)) {
+            assert(s == mp::incircle_exact(pts[0], pts[1], pts[2], pts[4]));
+        } else {
+            ++uncertain;
+        }
+        if (mp::insphere_filter(pts[0], pts[1], pts[2], pts[3], pts[4], s)) {
+            assert(s == mp::insphere_exact(pts[0], pts[1], pts[2], pts[3], pts[4]));
+        } else {
+            ++uncertain;
+        }
+        if (k % 8 == 0) {
+            assert(mp::incircle(pts[0], pts[1], pts[2], pts[4]) == 0);
+            assert(mp::insphere(pts[0], pts[1], pts[2], pts[3], pts[4]) == 0);
+        }
+    }
+    // Only the degenerate cases (2 predicates per 8 rounds) should miss the filter.
+    assert(uncertain <= rounds / 4 + rounds / 100);
+
+    std::cout << "Filter vs exact tests passed (" << uncertain << " of " << 4 * rounds
+              << " predicates needed the exact stage)\n";
+}
+
+void test_non_finite_input() {
+    const double a[2] = { 0.0, 0.0 }, b[2] = { 1.0, 0.0 };
+    const double c[2] = { std::nan(""), 1.0 };
+    int s = 0;
+    const bool certain = mp::orient2d_filter(a, b, c, s);
+    assert(!certain);
+    (void) certain;
+    bool thrown = false;
+    try {
+        mp::orient2d(a, b, c);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << "Non-finite input tests passed\n";
+}
+
+void test_orient3d_batch() {
+    std::mt19937_64 rng(777);
+    std::uniform_real_distribution<double> coord(-1.0, 1.0);
+    // Odd size so SIMD builds also exercise the scalar tail.
+    const std::size_t n = 1003;
+    std::vector<double> c[12];
+    for (auto& v : c) {
+        v.resize(n);
+        for (double& x : v) {
+            x = coord(rng);
+        }
+    }
+    // Every 10th quadruple is coplanar: d = a + (b - a) + (c - a) on grid values.
+    for (std::size_t i = 0; i < n; i += 10) {
+        for (int k = 0; k < 3; ++k) {
+            c[k][i] = std::ldexp(std::floor(c[k][i] * 1024.0), -10);
+            c[3 + k][i] = std::ldexp(std::floor(c[3 + k][i] * 1024.0), -10);
+            c[6 + k][i] = std::ldexp(std::floor(c[6 + k][i] * 1024.0), -10);
+            c[9 + k][i] = c[3 + k][i] + c[6 + k][i] - c[k][i];
+        }
+    }
+    const mp::Orient3dBatch batch = {
+        c[0].data(), c[1].data(), c[2].data(), c[3].data(), c[4].data(), c[5].data(),
+        c[6].data(), c[7].data(), c[8].data(), c[9].data(), c[10].data(), c[11].data(), n
+    };
+
+    std::vector<int> signs(n);
+    std::vector<std::size_t> uncertain(n);
+    const std::size_t count = mp::orient3d_filter_batch(batch, signs.data(), uncertain.data());
+    assert(count >= n / 10 && count < n / 5);
+    for (std::size_t k = 0; k < count; ++k) {
+        assert(signs[uncertain[k]] == 0);
+        assert(k == 0 || uncertain[k] > uncertain[k - 1]);
+    }
+
+    mp::orient3d_batch(batch, signs.data(), uncertain.data());
+    for (std::size_t i = 0; i < n; ++i) {
+        const double pa[3] = { c[0][i], c[1][i], c[2][i] };
+        const double pb[3] = { c[3][i], c[4][i], c[5][i] };
+        const double pc[3] = { c[6][i], c[7][i], c[8][i] };
+        const double pd[3] = { c[9][i], c[10][i], c[11][i] };
+        assert(signs[i] == mp::orient3d_exact(pa, pb, pc, pd));
+        if (i % 10 == 0) {
+            assert(signs[i] == 0);
+        }
+    }
+
+    const mp::Orient3dBatch empty = { nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+                                      nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, 0 };
+    const std::size_t empty_count = mp::orient3d_filter_batch(empty, nullptr, nullptr);
+    assert(empty_count == 0);
+    (void) empty_count;
+
+    std::cout << "Batched orient3d tests passed (" << count << " of " << n << " uncertain)\n";
+}
+
+} // namespace
+
+int main() {
+    test_known_configurations();
+    test_near_degenerate_orient2d();
+    test_expansion_stage();
+    test_filter_agrees_with_exact();
+    test_non_finite_input();
+    test_orient3d_batch();
+
+    std::cout << "\nAll MiniMPFPredicates tests passed!\n";
+    return 0;
+}
@@ -4,9 +4,11 @@
 // test_MiniMPZ.cpp
 #include "../MiniMPZ.hpp"
 #include "geometry_workloads.hpp"
+#include <algorithm>
 #include <iostream>
 #include <cassert>
 #include <limits>
+#include <unordered_set>
 #include <vector>
 
 void test_construction() {
@@ -407,6 +409,86 @@ void test_move_semantics_with_local_buffer() {
     std::cout << "Move semantics tests passed\n";
 }
 
+void test_swap_and_sort_mixed_storage() {
+    const std::string small_value = "-12345";
+    const std::string big_value = "123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789";
+
+    // local buffer <-> heap, both directions
+    MiniMPZ a(small_value);
+    MiniMPZ b(big_value);
+    a.swap(b);
+    assert(a.to_string() == big_value);
+    assert(b.to_string() == small_value);
+    using std::swap;
+    swap(a, b);
+    assert(a.to_string() == small_value);
+    assert(b.to_string() == big_value);
+
+    // local buffer <-> local buffer, then the swapped values must stay
+    // independent (each _mp_d points to its own buffer)
+    MiniMPZ c(7L);
+    a.swap(c);
+    assert(a.to_long() == 7 && c.to_string() == small_value);
+    a += MiniMPZ(1L);
+    assert(a.to_long() == 8 && c.to_string() == small_value);
+
+    // move assignment from a local-buffer value into a heap-backed target
+    MiniMPZ target(big_value);
+    MiniMPZ source(small_value);
+    target = std::move(source);
+    assert(target.to_string() == small_value);
+    assert(source.sign() == 0);
+    source = MiniMPZ(big_value);
+    assert(source.to_string() == big_value);
+
+    std::vector<MiniMPZ> values;
+    for (long i = 0; i < 64; ++i) {
+        MiniMPZ v((i * 37) % 64 - 32);
+        if ((i % 3) == 0) {
+            v *= MiniMPZ(big_value);
+        }
+        values.push_back(std::move(v));
+    }
+    std::sort(values.begin(), values.end());
+    for (std::size_t i = 1; i < values.size(); ++i) {
+        assert(values[i - 1] <= values[i]);
+    }
+
+    std::cout << "Swap/sort tests passed\n";
+}
+
+void test_hash() {
+    const MiniMPZ big("123456789012345678901234567890123456789012345678901234567890");
+    std::hash<MiniMPZ> hasher;
+
+    // Equal values hash the same, whatever their storage history.
+    MiniMPZ grown = big * MiniMPZ(big);
+    grown = grown / big;
+    assert(grown == big && hasher(grown) == hasher(big));
+    assert(hasher(MiniMPZ(0L)) == hasher(big - big));
+    assert(hasher(big) != hasher(-big));
+    assert(hasher(MiniMPZ(1L)) != hasher(MiniMPZ(2L)));
+
+    // hash(k) on a value with k low zero bits is the hash of the quotient.
+    for (unsigned long k = 0; k < 200; k += 7) {
+        MiniMPZ shifted;
+        mpz_mul_2exp(shifted.get_mpz(), big.get_mpz(), k);
+        assert(shifted.hash(k) == big.hash());
+        mpz_neg(shifted.get_mpz(), shifted.get_mpz());
+        assert(shifted.hash(k) == (-big).hash());
+    }
+
+    std::unordered_set<MiniMPZ> set;
+    for (long i = -500; i < 500; ++i) {
+        set.insert(MiniMPZ(i) * big);
+    }
+    assert(set.size() == 1000);
+    assert(set.count(MiniMPZ(-3L) * big) == 1);
+    assert(set.count(MiniMPZ(7L)) == 0);
+
+    std::cout << "Hash tests passed\n";
+}
+
 int main() {
     try {
         test_construction();
@@ -423,6 +505,8 @@ int main() {
         test_sqrt_and_gcd_workloads();
         test_addmul_submul_fast_path();
         test_move_semantics_with_local_buffer();
+        test_swap_and_sort_mixed_storage();
+        test_hash();
 
         std::cout << "\nAll tests passed!\n";
     } catch (const std::exception& e) {
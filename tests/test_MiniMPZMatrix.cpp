@@ -0,0 +1,144 @@
+// test_MiniMPZMatrix.cpp
+#include "../MiniMPZMatrix.hpp"
+#include "geometry_workloads.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+uint64_t lcg_next(uint64_t& state) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return state >> 33U;
+}
+
+MiniMPZMatrix random_matrix(std::size_t rows, std::size_t cols, uint64_t seed) {
+    MiniMPZMatrix m(rows, cols);
+    for (std::size_t i = 0; i < rows; ++i) {
+        for (std::size_t j = 0; j < cols; ++j) {
+            m(i, j) = MiniMPZ(static_cast<long>(lcg_next(seed) % 2001U) - 1000L);
+        }
+    }
+    return m;
+}
+
+void test_determinant_matches_cofactor_expansion() {
+    for (uint64_t seed = 1; seed <= 20; ++seed) {
+        const MiniMPZMatrix m = random_matrix(4, 4, seed);
+        mini_gmp_plus_geometry::Matrix4 a;
+        for (std::size_t k = 0; k < 16; ++k) {
+            a[k] = m(k / 4, k % 4);
+        }
+        assert(m.determinant() == mini_gmp_plus_geometry::determinant4(a));
+
+        const MiniMPZMatrix m3 = random_matrix(3, 3, seed + 100);
+        mini_gmp_plus_geometry::Matrix3 a3;
+        for (std::size_t k = 0; k < 9; ++k) {
+            a3[k] = m3(k / 3, k % 3);
+        }
+        assert(m3.determinant() == mini_gmp_plus_geometry::determinant3(a3));
+    }
+
+    // Needs a row exchange (zero leading entry) and flips the sign.
+    MiniMPZMatrix p(2, 2);
+    p(0, 1) = MiniMPZ(1L);
+    p(1, 0) = MiniMPZ(1L);
+    assert(p.determinant().to_long() == -1);
+
+    std::cout << "Determinant vs cofactor tests passed\n";
+}
+
+void test_large_determinant() {
+    // Vandermonde matrix: det = prod_{i<j} (x_j - x_i)
+    const std::size_t n = 24;
+    MiniMPZMatrix v(n, n);
+    MiniMPZ expected(1L);
+    for (std::size_t i = 0; i < n; ++i) {
+        const MiniMPZ xi(static_cast<long>(3 * i * i + 1));
+        MiniMPZ p(1L);
+        for (std::size_t j = 0; j < n; ++j) {
+            v(i, j) = p;
+            p *= xi;
+        }
+        for (std::size_t k = 0; k < i; ++k) {
+            expected *= xi - MiniMPZ(static_cast<long>(3 * k * k + 1));
+        }
+    }
+    assert(v.determinant() == expected);
+
+    std::cout << "Large determinant tests passed\n";
+}
+
+void test_rank() {
+    MiniMPZMatrix m = random_matrix(6, 8, 7);
+    assert(m.rank() == 6);
+
+    // Row 3 = row 0 + 2 * row 1, row 5 = row 2 - row 4, column 0 all zero
+    for (std::size_t j = 0; j < 8; ++j) {
+        m(3, j) = m(0, j) + MiniMPZ(2L) * m(1, j);
+        m(5, j) = m(2, j) - m(4, j);
+    }
+    for (std::size_t i = 0; i < 6; ++i) {
+        m(i, 0) = MiniMPZ(0L);
+    }
+    assert(m.rank() == 4);
+    assert(MiniMPZMatrix(3, 5).rank() == 0);
+
+    MiniMPZMatrix singular(3, 3);
+    singular(0, 0) = MiniMPZ(1L);
+    singular(1, 1) = MiniMPZ(1L);
+    assert(singular.determinant().sign() == 0);
+
+    std::cout << "Rank tests passed\n";
+}
+
+void test_solve() {
+    const std::size_t n = 12;
+    const MiniMPZMatrix a = random_matrix(n, n, 42);
+    std::vector<MiniMPZ> b(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        b[i] = MiniMPZ(static_cast<long>(i * i) - 17L);
+    }
+
+    std::vector<MiniMPZ> x;
+    MiniMPZ d;
+    const bool ok = a.solve(b, x, d);
+    assert(ok);
+    (void) ok;
+    assert(d.sign() > 0);
+    assert(d == a.determinant().abs());
+
+    // A * x == d * b
+    for (std::size_t i = 0; i < n; ++i) {
+        MiniMPZ lhs;
+        for (std::size_t j = 0; j < n; ++j) {
+            mpz_addmul(lhs.get_mpz(), a(i, j).get_mpz(), x[j].get_mpz());
+        }
+        assert(lhs == d * b[i]);
+    }
+
+    MiniMPZMatrix singular(2, 2);
+    singular(0, 0) = MiniMPZ(2L);
+    singular(0, 1) = MiniMPZ(4L);
+    singular(1, 0) = MiniMPZ(1L);
+    singular(1, 1) = MiniMPZ(2L);
+    const bool singular_ok = singular.solve(std::vector<MiniMPZ>(2), x, d);
+    assert(!singular_ok);
+    (void) singular_ok;
+
+    std::cout << "Solve tests passed\n";
+}
+
+} // namespace
+
+int main() {
+    test_determinant_matches_cofactor_expansion();
+    test_large_determinant();
+    test_rank();
+    test_solve();
+
+    std::cout << "\nAll MiniMPZMatrix tests passed!\n";
+    return 0;
+}
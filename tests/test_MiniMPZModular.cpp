@@ -0,0 +1,128 @@
+// test_MiniMPZModular.cpp
+#include "../MiniMPZModular.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+uint64_t lcg_next(uint64_t& state) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return state >> 33U;
+}
+
+MiniMPZMatrix random_matrix(std::size_t n, uint64_t seed, bool wide_entries) {
+    MiniMPZMatrix m(n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            MiniMPZ v(static_cast<long>(lcg_next(seed) % 2001U) - 1000L);
+            if (wide_entries) {
+                // ~200-bit entries
+                for (int k = 0; k < 6; ++k) {
+                    v = v * MiniMPZ(static_cast<long>(lcg_next(seed) | 1U)) + MiniMPZ(static_cast<long>(lcg_next(seed)));
+                }
+            }
+            m(i, j) = v;
+        }
+    }
+    return m;
+}
+
+void test_crt_basis() {
+    const std::vector<uint64_t> primes(mini_gmp_plus_modular::detail::primes(7).begin(),
+                                       mini_gmp_plus_modular::detail::primes(7).begin() + 7);
+    for (std::size_t k = 0; k < primes.size(); ++k) {
+        assert(primes[k] > (uint64_t(1) << 61) && primes[k] < (uint64_t(1) << 62));
+        assert(k == 0 || primes[k] < primes[k - 1]);
+    }
+    const mini_gmp_plus_modular::CrtBasis basis(primes);
+
+    const char* values[] = {
+        "0", "1", "-1", "123456789012345678901234567890123456789012345678901234567890",
+        "-98765432109876543210987654321098765432109876543210987654321098765432109876543210"
+    };
+    for (const char* s : values) {
+        const MiniMPZ x(s);
+        std::vector<uint64_t> residues(primes.size());
+        for (std::size_t k = 0; k < primes.size(); ++k) {
+            const mini_gmp_plus_modular::detail::Montgomery mont(primes[k]);
+            residues[k] = mont.from_mont(mont.reduce(x.get_mpz()));
+        }
+        assert(basis.reconstruct(residues) == x);
+    }
+
+    std::cout << "CRT basis tests passed\n";
+}
+
+void test_determinant_matches_bareiss() {
+    for (uint64_t seed = 1; seed <= 10; ++seed) {
+        const MiniMPZMatrix small = random_matrix(6, seed, false);
+        assert(mini_gmp_plus_modular::determinant(small) == small.determinant());
+
+        const MiniMPZMatrix wide = random_matrix(12, seed + 50, true);
+        assert(mini_gmp_plus_modular::determinant(wide) == wide.determinant());
+    }
+
+    MiniMPZMatrix m = random_matrix(9, 3, false);
+    for (std::size_t j = 0; j < 9; ++j) {
+        m(4, j) = m(1, j) - m(7, j);
+    }
+    assert(mini_gmp_plus_modular::determinant(m).sign() == 0);
+
+    MiniMPZMatrix p(2, 2);
+    p(0, 1) = MiniMPZ(1L);
+    p(1, 0) = MiniMPZ(1L);
+    assert(mini_gmp_plus_modular::determinant(p).to_long() == -1);
+
+    std::cout << "Determinant vs Bareiss tests passed\n";
+}
+
+void test_solve_matches_bareiss() {
+    const std::size_t n = 15;
+    for (uint64_t seed = 1; seed <= 4; ++seed) {
+        const MiniMPZMatrix a = random_matrix(n, seed, seed % 2 == 0);
+        std::vector<MiniMPZ> b(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            b[i] = MiniMPZ(static_cast<long>(lcg_next(seed) % 1000U) - 500L);
+        }
+
+        std::vector<MiniMPZ> x, x_ref;
+        MiniMPZ d, d_ref;
+        const bool ok = mini_gmp_plus_modular::solve(a, b, x, d);
+        const bool ok_ref = a.solve(b, x_ref, d_ref);
+        assert(ok && ok_ref);
+        (void) ok;
+        (void) ok_ref;
+        assert(d == d_ref);
+        for (std::size_t i = 0; i < n; ++i) {
+            assert(x[i] == x_ref[i]);
+        }
+    }
+
+    MiniMPZMatrix singular(2, 2);
+    singular(0, 0) = MiniMPZ(2L);
+    singular(0, 1) = MiniMPZ(4L);
+    singular(1, 0) = MiniMPZ(1L);
+    singular(1, 1) = MiniMPZ(2L);
+    std::vector<MiniMPZ> x;
+    MiniMPZ d;
+    const bool singular_ok =
+        mini_gmp_plus_modular::solve(singular, std::vector<MiniMPZ>(2, MiniMPZ(1L)), x, d);
+    assert(!singular_ok);
+    (void) singular_ok;
+
+    std::cout << "Solve vs Bareiss tests passed\n";
+}
+
+} // namespace
+
+int main() {
+    test_crt_basis();
+    test_determinant_matches_bareiss();
+    test_solve_matches_bareiss();
+
+    std::cout << "\nAll MiniMPZModular tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,101 @@
+// test_MiniMPZVector.cpp
+#include "../MiniMPZVector.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void test_append_and_view() {
+    const std::vector<std::string> values = {
+        "0", "42", "-18446744073709551616",
+        "123456789012345678901234567890123456789012345678901234567890",
+        "-7"
+    };
+
+    MiniMPZVector v;
+    for (const std::string& s : values) {
+        v.push_back(MiniMPZ(s));
+    }
+    assert(v.size() == values.size());
+
+    // 0 + 1 + 2 + 4 + 1 limbs, stored back to back
+    assert(v.limb_count() == 8);
+    assert(v.limbs(2) + v.limb_size(2) == v.limbs(3));
+
+    mpz_t holder;
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        assert(v.get(i).to_string() == values[i]);
+        assert(mpz_cmp(v.view(i, holder), MiniMPZ(values[i]).get_mpz()) == 0);
+    }
+    assert(v.sign(0) == 0 && v.sign(1) == 1 && v.sign(2) == -1);
+    assert(mpz_even_p(v.view(0, holder)));
+
+    std::cout << "Append/view tests passed\n";
+}
+
+void test_update_in_place_and_compact() {
+    MiniMPZVector v;
+    v.push_back(MiniMPZ(5L), 2);
+    v.push_back(MiniMPZ(-9L));
+
+    // Fits the reserved capacity: stays in place
+    const MiniMPZ two_limbs("340282366920938463463374607431768211455");
+    v.set(0, two_limbs);
+    assert(v.get(0) == two_limbs);
+    assert(v.wasted_limbs() == 0);
+
+    // Outgrows the capacity: relocated to the end of the slab
+    const MiniMPZ big = two_limbs * two_limbs;
+    v.set(1, big);
+    assert(v.get(1) == big);
+    assert(v.wasted_limbs() == 1);
+
+    // Update from a view into the same container
+    mpz_t holder;
+    v.set(0, v.view(1, holder));
+    assert(v.get(0) == big);
+    v.push_back(v.view(1, holder));
+    assert(v.get(2) == big);
+
+    v.compact();
+    assert(v.wasted_limbs() == 0);
+    assert(v.limb_count() == 12);
+    assert(v.get(0) == big && v.get(1) == big && v.get(2) == big);
+
+    std::cout << "Update/compact tests passed\n";
+}
+
+void test_linear_scan() {
+    MiniMPZVector v;
+    MiniMPZ expected;
+    MiniMPZ x("1000000000000000000000000000007");
+    for (long i = 0; i < 1000; ++i) {
+        x *= MiniMPZ(i % 2 == 0 ? 3L : -5L);
+        x %= MiniMPZ("1000000000000000000000000000000000000000000000000000000000057");
+        v.push_back(x);
+        expected += x;
+    }
+
+    MiniMPZ sum;
+    mpz_t holder;
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        mpz_add(sum.get_mpz(), sum.get_mpz(), v.view(i, holder));
+    }
+    assert(sum == expected);
+
+    std::cout << "Linear scan tests passed\n";
+}
+
+} // namespace
+
+int main() {
+    test_append_and_view();
+    test_update_in_place_and_compact();
+    test_linear_scan();
+
+    std::cout << "\nAll MiniMPZVector tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,128 @@
+// test_SmallMPZ.cpp
+#include "../SmallMPZ.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+void test_inline_capacity_and_size() {
+    static_assert(sizeof(SmallMPZ<1>) < sizeof(__mpz_struct), "SmallMPZ<1> should be smaller than mpz_t");
+
+    SmallMPZ<1> a(42L);
+    assert(a.is_small());
+    assert(a.capacity() == 1);
+    assert(a.to_long() == 42);
+
+    SmallMPZ<8> b(MiniMPZ("340282366920938463463374607431768211457"));
+    assert(b.is_small());
+    assert(b.size() == 3);
+
+    std::cout << "Inline capacity tests passed\n";
+}
+
+void test_arithmetic_against_minimpz() {
+    const char* values[] = {
+        "0", "1", "-1", "18446744073709551615", "-18446744073709551616",
+        "123456789012345678901234567890", "-987654321098765432109876543210",
+        "340282366920938463463374607431768211455"
+    };
+    for (const char* x : values) {
+        for (const char* y : values) {
+            const MiniMPZ mx(x);
+            const MiniMPZ my(y);
+            const SmallMPZ<2> sx(mx);
+            const SmallMPZ<2> sy(my);
+
+            assert((sx + sy).to_mpz() == mx + my);
+            assert((sx - sy).to_mpz() == mx - my);
+            assert((sx * sy).to_mpz() == mx * my);
+            assert((-sx).to_mpz() == -mx);
+            assert((sx < sy) == (mx < my));
+            assert((sx == sy) == (mx == my));
+
+            SmallMPZ<2> acc(sx);
+            acc += sy;
+            acc *= acc;
+            acc -= sx;
+            assert(acc.to_mpz() == (mx + my) * (mx + my) - mx);
+        }
+    }
+
+    std::cout << "Arithmetic tests passed\n";
+}
+
+void test_spill_and_move() {
+    SmallMPZ<1> a(MiniMPZ("123456789012345678901234567890"));
+    assert(!a.is_small());
+
+    SmallMPZ<1> b(std::move(a));
+    assert(b.to_string() == "123456789012345678901234567890");
+    assert(a.sign() == 0);
+    assert(a.is_small());
+
+    SmallMPZ<1> c(7L);
+    c = std::move(b);
+    assert(c.to_string() == "123456789012345678901234567890");
+
+    SmallMPZ<1> d(-5L);
+    swap(c, d);
+    assert(c.to_long() == -5);
+    assert(d.to_string() == "123456789012345678901234567890");
+
+    std::vector<SmallMPZ<2>> values;
+    values.reserve(1);
+    for (long i = 0; i < 16; ++i) {
+        values.push_back(SmallMPZ<2>(i - 8));
+    }
+    for (long i = 0; i < 16; ++i) {
+        assert(values[static_cast<size_t>(i)].to_long() == i - 8);
+    }
+
+    std::cout << "Spill/move tests passed\n";
+}
+
+void test_c_api_interop() {
+    SmallMPZ<4> a(MiniMPZ("-98765432109876543210987"));
+    SmallMPZ<4> b(MiniMPZ("123456789012345678901234"));
+
+    // Read-only views feed straight into the C API.
+    mpz_t va, vb;
+    MiniMPZ q;
+    mpz_tdiv_q(q.get_mpz(), b.view(vb), a.view(va));
+    assert(q.to_long() == -1);
+
+    // Results computed by the C API come back through set().
+    SmallMPZ<4> g;
+    MiniMPZ tmp;
+    mpz_gcd(tmp.get_mpz(), a.view(va), b.view(vb));
+    g.set(tmp.get_mpz());
+    assert(g.to_mpz() == tmp);
+
+    // mpn_ kernels write directly into the limbs.
+    SmallMPZ<4> r;
+    mp_ptr rp = r.limbs_write(3);
+    rp[0] = 1;
+    rp[1] = 2;
+    rp[2] = 0;
+    r.limbs_finish(-3);
+    assert(r.size() == 2);
+    assert(r.sign() == -1);
+
+    std::cout << "C API interop tests passed\n";
+}
+
+} // namespace
+
+int main() {
+    test_inline_capacity_and_size();
+    test_arithmetic_against_minimpz();
+    test_spill_and_move();
+    test_c_api_interop();
+
+    std::cout << "\nAll SmallMPZ tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,225 @@
+// Stress test of concurrent use: worker threads with their own thread-local
+// memory functions run mixed arithmetic (serial, parallel and batched) while
+// another thread keeps switching the SIMD level and the thread budget.  Every
+// block is tagged with the allocator that made it, so a block reallocated or
+// freed by another thread's functions is caught.  Meant to be run under the
+// tsan preset as well.
+
+#include "../mini-gmp.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kWorkers = 4;
+constexpr int kIterations = 60;
+constexpr std::size_t kBatch = 2000;
+constexpr std::size_t kHeader = 16;
+
+void check(bool ok, const char *what, int worker) {
+    if (!ok) {
+        std::fprintf(stderr, "%s failed in worker %d\n", what, worker);
+        std::abort();
+    }
+}
+
+struct Arena {
+    std::atomic<long> live{0};
+    std::atomic<long> allocations{0};
+};
+
+Arena arenas[kWorkers];
+
+// Blocks carry the index of their arena in a header.
+template <int I>
+void *arena_alloc(std::size_t size) {
+    unsigned char *p = static_cast<unsigned char *>(std::malloc(size + kHeader));
+    const int owner = I;
+    check(p != nullptr, "arena_alloc", I);
+    std::memcpy(p, &owner, sizeof owner);
+    arenas[I].live.fetch_add(static_cast<long>(size), std::memory_order_relaxed);
+    arenas[I].allocations.fetch_add(1, std::memory_order_relaxed);
+    return p + kHeader;
+}
+
+template <int I>
+unsigned char *arena_block(void *q) {
+    unsigned char *p = static_cast<unsigned char *>(q) - kHeader;
+    int owner;
+    std::memcpy(&owner, p, sizeof owner);
+    check(owner == I, "block owner", I);
+    return p;
+}
+
+template <int I>
+void *arena_realloc(void *q, std::size_t old_size, std::size_t new_size) {
+    unsigned char *p = static_cast<unsigned char *>(std::realloc(arena_block<I>(q), new_size + kHeader));
+    check(p != nullptr, "arena_realloc", I);
+    arenas[I].live.fetch_add(static_cast<long>(new_size) - static_cast<long>(old_size),
+                             std::memory_order_relaxed);
+    return p + kHeader;
+}
+
+template <int I>
+void arena_free(void *q, std::size_t size) {
+    std::free(arena_block<I>(q));
+    arenas[I].live.fetch_sub(static_cast<long>(size), std::memory_order_relaxed);
+}
+
+template <int I>
+void use_arena() {
+    mp_set_thread_memory_functions(arena_alloc<I>, arena_realloc<I>, arena_free<I>);
+}
+
+void (*const use_arenas[kWorkers])() = { use_arena<0>, use_arena<1>, use_arena<2>, use_arena<3> };
+
+void random_mpz(mpz_t x, std::mt19937_64 &rng, int limbs) {
+    mp_limb_t *p = mpz_limbs_write(x, limbs);
+    for (int i = 0; i < limbs; ++i)
+        p[i] = rng();
+    mpz_limbs_finish(x, (rng() & 1) ? -limbs : limbs);
+}
+
+void worker(int id) {
+    use_arenas[id]();
+
+    void *(*alloc)(std::size_t);
+    void (*free_func)(void *, std::size_t);
+    mp_get_memory_functions(&alloc, nullptr, &free_func);
+    check(alloc != nullptr && free_func != nullptr, "mp_get_memory_functions", id);
+
+    std::mt19937_64 rng(0x7e57 + id);
+    mpz_t a, b, m, q, r, s, t;
+    mpz_init(a);
+    mpz_init(b);
+    mpz_init(m);
+    mpz_init(q);
+    mpz_init(r);
+    mpz_init(s);
+    mpz_init(t);
+
+    for (int i = 0; i < kIterations; ++i) {
+        const bool big = i % 10 == 0;
+        random_mpz(a, rng, big ? 600 : 1 + static_cast<int>(rng() % 40));
+        random_mpz(b, rng, big ? 600 : 1 + static_cast<int>(rng() % 40));
+        random_mpz(m, rng, 1 + static_cast<int>(rng() % 8));
+        if (mpz_sgn(b) == 0)
+            mpz_set_ui(b, 3);
+        if (mpz_sgn(m) == 0)
+            mpz_set_ui(m, 7);
+
+        // Products, serial and split across the pool.
+        mpz_mul(s, a, b);
+        mpz_mul_threads(t, a, b, 3);
+        check(mpz_cmp(s, t) == 0, "mpz_mul_threads", id);
+
+        // Division: a = q b + r with |r| < |b|.
+        mpz_tdiv_qr(q, r, a, b);
+        mpz_mul(t, q, b);
+        mpz_add(t, t, r);
+        check(mpz_cmp(t, a) == 0 && mpz_cmpabs(r, b) < 0, "mpz_tdiv_qr", id);
+
+        // The gcd divides both operands.
+        mpz_gcd(t, a, b);
+        check(mpz_divisible_p(a, t) && mpz_divisible_p(b, t), "mpz_gcd", id);
+
+        // a^2 mod m two ways.
+        mpz_set_ui(t, 2);
+        mpz_powm(s, a, t, m);
+        mpz_mul(t, a, a);
+        mpz_mod(t, t, m);
+        check(mpz_cmp(s, t) == 0, "mpz_powm", id);
+
+        // Strings come from, and go back to, this thread's functions.
+        char *str = mpz_get_str(nullptr, 16, a);
+        mpz_set_str(t, str, 16);
+        check(mpz_cmp(t, a) == 0, "mpz_get_str", id);
+        free_func(str, std::strlen(str) + 1);
+    }
+
+    // Factorials on the pool against a running product, and a batch.
+    mpz_fac_ui(s, 3000 + id);
+    mpz_set_ui(t, 1);
+    for (unsigned long k = 2; k <= 3000ul + id; ++k)
+        mpz_mul_ui(t, t, k);
+    check(mpz_cmp(s, t) == 0, "mpz_fac_ui", id);
+
+    // The results of a batch are reallocated on the pool's threads.
+    std::vector<__mpz_struct> x(kBatch), y(kBatch), z(kBatch);
+    for (std::size_t k = 0; k < x.size(); ++k) {
+        mpz_init(&x[k]);
+        mpz_init(&y[k]);
+        mpz_init(&z[k]);
+        random_mpz(&x[k], rng, 1 + static_cast<int>(k % 20));
+        random_mpz(&y[k], rng, 1 + static_cast<int>(k % 7));
+    }
+    mpz_mul_batch(z.data(), x.data(), y.data(), x.size(), 4);
+    for (std::size_t k = 0; k < x.size(); ++k) {
+        mpz_mul(t, &x[k], &y[k]);
+        check(mpz_cmp(t, &z[k]) == 0, "mpz_mul_batch", id);
+    }
+    mpz_gcd_batch(z.data(), x.data(), y.data(), x.size(), 4);
+    for (std::size_t k = 0; k < x.size(); ++k) {
+        mpz_gcd(t, &x[k], &y[k]);
+        check(mpz_cmp(t, &z[k]) == 0, "mpz_gcd_batch", id);
+        mpz_clear(&x[k]);
+        mpz_clear(&y[k]);
+        mpz_clear(&z[k]);
+    }
+
+    mpz_clear(a);
+    mpz_clear(b);
+    mpz_clear(m);
+    mpz_clear(q);
+    mpz_clear(r);
+    mpz_clear(s);
+    mpz_clear(t);
+
+    mp_set_thread_memory_functions(nullptr, nullptr, nullptr);
+}
+
+void switcher(std::atomic<bool> *stop) {
+    static const char *const levels[] = { "scalar", "xsimd", "avx2", "avx512" };
+    for (unsigned i = 0; !stop->load(); ++i) {
+        mini_gmp_set_simd_level(levels[i % 4]);
+        mini_gmp_set_threads(1 + i % 3);
+        check(mini_gmp_simd_level() != nullptr && mini_gmp_threads() >= 1, "switcher", -1);
+        std::this_thread::yield();
+    }
+}
+
+} // namespace
+
+int main() {
+    const char *const initial_level = mini_gmp_simd_level();
+    std::atomic<bool> stop{false};
+
+    std::thread sw(switcher, &stop);
+    std::vector<std::thread> workers;
+    for (int id = 0; id < kWorkers; ++id)
+        workers.emplace_back(worker, id);
+    for (std::thread &w : workers)
+        w.join();
+    stop.store(true);
+    sw.join();
+
+    mini_gmp_set_simd_level(initial_level);
+    mini_gmp_set_threads(1);
+
+    // Every block went back to the arena that made it.
+    for (int id = 0; id < kWorkers; ++id) {
+        check(arenas[id].allocations.load() > 0, "arena used", id);
+        check(arenas[id].live.load() == 0, "arena balanced", id);
+    }
+
+    std::cout << "All thread stress tests passed!\n";
+    return 0;
+}
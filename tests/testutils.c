@@ -33,6 +33,15 @@ the GNU MP Library test suite.  If not, see https://www.gnu.org/licenses/.  */
 
 static size_t total_alloc = 0;
 
+/* The parallel operations allocate from the pool's threads too. */
+#if defined(__GNUC__) || defined(__clang__)
+#define TOTAL_ALLOC_ADD(n) __atomic_fetch_add (&total_alloc, (n), __ATOMIC_RELAXED)
+#define TOTAL_ALLOC_SUB(n) __atomic_fetch_sub (&total_alloc, (n), __ATOMIC_RELAXED)
+#else
+#define TOTAL_ALLOC_ADD(n) (total_alloc += (n))
+#define TOTAL_ALLOC_SUB(n) (total_alloc -= (n))
+#endif
+
 /* Custom memory allocation to track memory usage, and add a small red
    zone.
 
@@ -55,7 +64,7 @@ block_init (size_t *block, size_t size)
   p = (char *) block;
   memcpy (p + size, block_end, sizeof(block_end));
 
-  total_alloc += size;
+  TOTAL_ALLOC_ADD (size);
   return p;
 }
 
@@ -71,7 +80,7 @@ block_check  (void *p)
       fprintf (stderr, "red zone overwritten.\n");
       abort ();
     }
-  total_alloc -= size;
+  TOTAL_ALLOC_SUB (size);
   return block;
 }
 